@@ -6,28 +6,97 @@
 //
 
 #include "acknowledged_counter_generator.h"
-#include "utils/utils.h"
 
 namespace ycsbc {
+
+AcknowledgedCounterGenerator::AcknowledgedCounterGenerator(uint64_t start)
+    : CounterGenerator(start), limit_(start - 1), window_(new Window(kInitialWindowSize)) {}
+
+AcknowledgedCounterGenerator::~AcknowledgedCounterGenerator() {
+  Window *window = window_.load();
+  while (window != nullptr) {
+    Window *retired = window->retired;
+    delete window;
+    window = retired;
+  }
+}
+
 void AcknowledgedCounterGenerator::Acknowledge(uint64_t value) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  size_t cur_slot = value & kWindowMask;
-  if (ack_window_[cur_slot]) {
-    throw utils::Exception("Not enough window size");
+  for (;;) {
+    Window *window = window_.load();
+    // the slot of value must not hold a value that is still unacknowledged
+    if (value - limit_.load() <= window->mask + 1) {
+      break;
+    }
+    Grow(window, value);
   }
-  ack_window_[cur_slot] = true;
+  Publish(value);
+  Advance();
+}
+
+void AcknowledgedCounterGenerator::Publish(uint64_t value) {
+  Window *window = window_.load();
+  for (;;) {
+    // a slot only moves forward, so a late copy from a retired window
+    // cannot hide a newer value
+    std::atomic<uint64_t> &slot = window->Slot(value);
+    uint64_t tag = slot.load();
+    while (tag < value + 1 && !slot.compare_exchange_weak(tag, value + 1)) {
+    }
+    // a window installed meanwhile may have been copied without this value
+    Window *current = window_.load();
+    if (current == window) {
+      return;
+    }
+    window = current;
+  }
+}
+
+void AcknowledgedCounterGenerator::Grow(Window *window, uint64_t value) {
   uint64_t limit = limit_.load();
-  size_t until = limit + kWindowSize;
-  size_t i;
-  for (i = limit + 1; i < until; i++) {
-    size_t slot = i & kWindowMask;
-    if (!ack_window_[slot]) {
-      break;
+  uint64_t size = 2 * (window->mask + 1);
+  while (size < value - limit) {
+    size *= 2;
+  }
+  Window *grown = new Window(size);
+  grown->retired = window;
+  if (!window_.compare_exchange_strong(window, grown)) {
+    delete grown;
+    return;
+  }
+  // threads that acknowledged into the old window before the switch did
+  // not see it, so their values are carried over here
+  for (uint64_t i = 0; i <= window->mask; i++) {
+    uint64_t tag = window->slots[i].load();
+    // values past the watermark, compared modulo 2^64 as in Acknowledge
+    if (tag != 0 && tag - 1 - limit_.load() - 1 <= window->mask) {
+      Publish(tag - 1);
     }
-    ack_window_[slot] = false;
   }
-  limit_.store(i - 1);
+  Advance();
 }
 
-} // ycsbc
+void AcknowledgedCounterGenerator::Advance() {
+  Window *window = window_.load();
+  uint64_t limit = limit_.load();
+  for (;;) {
+    uint64_t next = limit + 1;
+    while (next - limit <= window->mask + 1 && window->Slot(next).load() == next + 1) {
+      next++;
+    }
+    if (next == limit + 1) {
+      Window *current = window_.load();
+      if (current == window) {
+        return;
+      }
+      window = current;
+      continue;
+    }
+    // on failure limit is reloaded, and the scan resumes from there
+    if (limit_.compare_exchange_weak(limit, next - 1)) {
+      limit = next - 1;
+    }
+  }
+}
 
+} // ycsbc
@@ -11,23 +11,60 @@
 #include "counter_generator.h"
 
 #include <atomic>
-#include <vector>
-#include <mutex>
+#include <memory>
 
 namespace ycsbc {
 
+///
+/// A counter whose Last() is the highest value below which every value
+/// handed out has been acknowledged, so that readers only choose keys that
+/// are inserted.
+///
+/// Acknowledgements go into a ring of slots, each holding the last value
+/// acknowledged in it (plus one, zero for none). Since a slot names its value,
+/// slots are never cleared: the watermark advances by CAS over slots that
+/// hold the values following it. A value too far ahead of the watermark for
+/// the ring grows it; the larger ring is installed with a CAS and the values
+/// of the old one are republished into it. Nothing takes a lock.
+///
 class AcknowledgedCounterGenerator : public CounterGenerator {
  public:
-  AcknowledgedCounterGenerator(uint64_t start)
-      : CounterGenerator(start), limit_(start - 1), ack_window_(kWindowSize, false) {}
-  uint64_t Last() { return limit_.load(); }
+  AcknowledgedCounterGenerator(uint64_t start);
+  ~AcknowledgedCounterGenerator();
+
+  uint64_t Last() { return limit_.load(std::memory_order_acquire); }
   void Acknowledge(uint64_t value);
+
  private:
-  static const size_t kWindowSize = (1 << 16);
-  static const size_t kWindowMask = kWindowSize - 1;
+  struct Window {
+    explicit Window(uint64_t size)
+        : mask(size - 1), slots(new std::atomic<uint64_t>[size]()), retired(nullptr) {}
+    std::atomic<uint64_t> &Slot(uint64_t value) { return slots[value & mask]; }
+
+    const uint64_t mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    Window *retired; // the window this one replaced, freed with the generator
+  };
+
+  static const uint64_t kInitialWindowSize = 1 << 14;
+
+  ///
+  /// Marks value acknowledged in the current window, and again in any
+  /// window installed meanwhile.
+  ///
+  void Publish(uint64_t value);
+  ///
+  /// Replaces window with one that holds value, unless another thread has
+  /// replaced it already.
+  ///
+  void Grow(Window *window, uint64_t value);
+  ///
+  /// Moves the watermark over the acknowledged values that follow it.
+  ///
+  void Advance();
+
   std::atomic<uint64_t> limit_;
-  std::vector<bool> ack_window_;
-  std::mutex mutex_;
+  std::atomic<Window *> window_;
 };
 
 } // ycsbc
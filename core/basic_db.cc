@@ -12,6 +12,23 @@
 namespace {
   const std::string PROP_SILENT = "basic.silent";
   const std::string PROP_SILENT_DEFAULT = "false";
+
+  // Keys as text, with bytes that are not printable escaped as \xNN
+  struct PrintableKey {
+    const std::string &key;
+  };
+
+  std::ostream &operator<<(std::ostream &out, PrintableKey k) {
+    static const char kHexDigits[] = "0123456789abcdef";
+    for (unsigned char c : k.key) {
+      if (c >= ' ' && c < 0x7f && c != '\\') {
+        out << c;
+      } else {
+        out << "\\x" << kHexDigits[c >> 4] << kHexDigits[c & 0xf];
+      }
+    }
+    return out;
+  }
 }
 
 namespace ycsbc {
@@ -31,7 +48,7 @@ void BasicDB::Init() {
 DB::Status BasicDB::Read(const std::string &table, const std::string &key,
                          const std::vector<std::string> *fields, std::vector<Field> &result) {
   std::lock_guard<std::mutex> lock(mutex_);
-  *out_ << "READ " << table << ' ' << key;
+  *out_ << "READ " << table << ' ' << PrintableKey{key};
   if (fields) {
     *out_ << " [ ";
     for (auto f : *fields) {
@@ -48,7 +65,7 @@ DB::Status BasicDB::Scan(const std::string &table, const std::string &key, int l
                          const std::vector<std::string> *fields,
                          std::vector<std::vector<Field>> &result) {
   std::lock_guard<std::mutex> lock(mutex_);
-  *out_ << "SCAN " << table << ' ' << key << " " << len;
+  *out_ << "SCAN " << table << ' ' << PrintableKey{key} << " " << len;
   if (fields) {
     *out_ << " [ ";
     for (auto f : *fields) {
@@ -64,7 +81,7 @@ DB::Status BasicDB::Scan(const std::string &table, const std::string &key, int l
 DB::Status BasicDB::Update(const std::string &table, const std::string &key,
                            std::vector<Field> &values) {
   std::lock_guard<std::mutex> lock(mutex_);
-  *out_ << "UPDATE " << table << ' ' << key << " [ ";
+  *out_ << "UPDATE " << table << ' ' << PrintableKey{key} << " [ ";
   for (auto v : values) {
     *out_ << v.name << '=' << v.value << ' ';
   }
@@ -75,7 +92,7 @@ DB::Status BasicDB::Update(const std::string &table, const std::string &key,
 DB::Status BasicDB::Insert(const std::string &table, const std::string &key,
                            std::vector<Field> &values) {
   std::lock_guard<std::mutex> lock(mutex_);
-  *out_ << "INSERT " << table << ' ' << key << " [ ";
+  *out_ << "INSERT " << table << ' ' << PrintableKey{key} << " [ ";
   for (auto v : values) {
     *out_ << v.name << '=' << v.value << ' ';
   }
@@ -85,7 +102,7 @@ DB::Status BasicDB::Insert(const std::string &table, const std::string &key,
 
 DB::Status BasicDB::Delete(const std::string &table, const std::string &key) {
   std::lock_guard<std::mutex> lock(mutex_);
-  *out_ << "DELETE " << table << ' ' << key << std::endl;
+  *out_ << "DELETE " << table << ' ' << PrintableKey{key} << std::endl;
   return kOK;
 }
 
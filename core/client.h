@@ -9,37 +9,202 @@
 #ifndef YCSB_C_CLIENT_H_
 #define YCSB_C_CLIENT_H_
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <string>
 
 #include "db.h"
+#include "db_wrapper.h"
 #include "core_workload.h"
+#include "utils/arrival.h"
 #include "utils/countdown_latch.h"
 #include "utils/rate_limit.h"
 #include "utils/utils.h"
+#include "utils/work_counter.h"
 
 namespace ycsbc {
 
-inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_ops, bool is_loading,
-                        bool init_db, bool cleanup_db, utils::CountDownLatch *latch, utils::RateLimiter *rlim) {
+///
+/// Time limits of the run phase, shared by the client threads.
+/// Operations issued while measuring is false are warm-up and not counted.
+///
+struct RunControl {
+  std::atomic<bool> stop{false};
+  std::atomic<bool> measuring{true};
+};
 
+///
+/// Client loop issuing the operations claimed from work until it runs out.
+///
+inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, utils::WorkCounter *work, bool is_loading,
+                        bool init_db, bool cleanup_db, utils::CountDownLatch *latch, utils::RateLimiter *rlim,
+                        utils::ArrivalProcess *arrival, RunControl *control) {
+
+  try {
+    if (init_db) {
+      db->Init();
+    }
+
+    // A batch counts as one operation per key
+    const int batch_size = wl->batch_size();
+    int64_t claimed = 0;
+    int measured_ops = 0;
+    while (true) {
+      if (control && control->stop.load(std::memory_order_relaxed)) {
+        break;
+      }
+      if (claimed == 0) {
+        int64_t first;
+        if ((claimed = work->Claim(&first)) == 0) {
+          break;
+        }
+        if (is_loading) {
+          wl->ClaimInsertKeys(first, claimed);
+        }
+      }
+      if (!is_loading && wl->Exhausted()) {
+        break;
+      }
+      int n = std::min<int64_t>(batch_size, claimed);
+      if (rlim) {
+        rlim->Consume(is_loading ? n : 1);
+      }
+      if (arrival) {
+        DBWrapper::SetIntendedStart(arrival->Next());
+      }
+
+      if (is_loading) {
+        if (batch_size > 1) {
+          wl->DoBatchInsert(*db, n);
+        } else {
+          wl->DoInsert(*db);
+        }
+      } else {
+        n = wl->DoBatchTransaction(*db, n);
+        // the rest of a batch is paid for once its size is known
+        if (rlim && n > 1) {
+          rlim->Consume(n - 1);
+        }
+      }
+      claimed -= n;
+      if (!control || control->measuring.load(std::memory_order_relaxed)) {
+        measured_ops += n;
+      }
+    }
+    DBWrapper::ClearIntendedStart();
+
+    if (cleanup_db) {
+      db->Cleanup();
+    }
+
+    latch->CountDown();
+    return measured_ops;
+  } catch (const utils::Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    exit(1);
+  }
+}
+
+///
+/// Client loop of the bulk load, inserting the chunks of sorted keys claimed from work.
+///
+inline int BulkLoadThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const uint64_t *keys,
+                          utils::WorkCounter *work, bool init_db, bool cleanup_db,
+                          utils::CountDownLatch *latch) {
   try {
     if (init_db) {
       db->Init();
     }
 
     int ops = 0;
-    for (int i = 0; i < num_ops; ++i) {
+    int64_t start;
+    int64_t n;
+    while ((n = work->Claim(&start)) > 0) {
+      wl->DoBulkInsert(*db, keys + start, n);
+      ops += n;
+    }
+
+    if (cleanup_db) {
+      db->Cleanup();
+    }
+
+    latch->CountDown();
+    return ops;
+  } catch (const utils::Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    exit(1);
+  }
+}
+
+///
+/// Client loop keeping up to queue_depth asynchronous operations in flight.
+/// Operations are issued one key at a time, regardless of the batch size.
+///
+inline int AsyncClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, utils::WorkCounter *work, bool is_loading,
+                             bool init_db, bool cleanup_db, utils::CountDownLatch *latch,
+                             utils::RateLimiter *rlim, utils::ArrivalProcess *arrival, int queue_depth,
+                             RunControl *control) {
+  try {
+    if (init_db) {
+      db->Init();
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int inflight = 0;
+    auto done = [&](bool) {
+      std::lock_guard<std::mutex> lock(mutex);
+      inflight--;
+      cv.notify_one();
+    };
+
+    int ops = 0;
+    int64_t claimed = 0;
+    while (true) {
+      if (control && control->stop.load(std::memory_order_relaxed)) {
+        break;
+      }
+      if (claimed == 0) {
+        int64_t first;
+        if ((claimed = work->Claim(&first)) == 0) {
+          break;
+        }
+        if (is_loading) {
+          wl->ClaimInsertKeys(first, claimed);
+        }
+      }
+      if (!is_loading && wl->Exhausted()) {
+        break;
+      }
+      claimed--;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return inflight < queue_depth; });
+        inflight++;
+      }
       if (rlim) {
         rlim->Consume(1);
       }
+      if (arrival) {
+        DBWrapper::SetIntendedStart(arrival->Next());
+      }
 
       if (is_loading) {
-        wl->DoInsert(*db);
+        wl->DoInsertAsync(*db, done);
       } else {
-        wl->DoTransaction(*db);
+        wl->DoTransactionAsync(*db, done);
+      }
+      if (!control || control->measuring.load(std::memory_order_relaxed)) {
+        ops++;
       }
-      ops++;
+    }
+    DBWrapper::ClearIntendedStart();
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return inflight == 0; });
     }
 
     if (cleanup_db) {
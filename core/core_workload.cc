@@ -11,12 +11,19 @@
 #include "zipfian_generator.h"
 #include "scrambled_zipfian_generator.h"
 #include "skewed_latest_generator.h"
+#include "moving_zipfian_generator.h"
+#include "hotspot_generator.h"
+#include "sequential_generator.h"
+#include "exponential_generator.h"
 #include "const_generator.h"
+#include "histogram_generator.h"
 #include "core_workload.h"
-#include "random_byte_generator.h"
 #include "utils/utils.h"
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <memory>
 #include <random>
 #include <string>
 
@@ -30,12 +37,18 @@ const char *ycsbc::kOperationString[ycsbc::MAXOPTYPE] = {
   "SCAN",
   "READMODIFYWRITE",
   "DELETE",
+  "BATCH-READ",
+  "BATCH-UPDATE",
+  "BATCH-INSERT",
   "INSERT-FAILED",
   "READ-FAILED",
   "UPDATE-FAILED",
   "SCAN-FAILED",
   "READMODIFYWRITE-FAILED",
-  "DELETE-FAILED"
+  "DELETE-FAILED",
+  "BATCH-READ-FAILED",
+  "BATCH-UPDATE-FAILED",
+  "BATCH-INSERT-FAILED"
 };
 
 const string CoreWorkload::TABLENAME_PROPERTY = "table";
@@ -50,6 +63,13 @@ const string CoreWorkload::FIELD_LENGTH_DISTRIBUTION_DEFAULT = "constant";
 const string CoreWorkload::FIELD_LENGTH_PROPERTY = "fieldlength";
 const string CoreWorkload::FIELD_LENGTH_DEFAULT = "100";
 
+const string CoreWorkload::FIELD_LENGTH_HISTOGRAM_PROPERTY = "field_len_histogram";
+
+const string CoreWorkload::UPDATE_FIELD_LENGTH_PREFIX = "update.";
+
+const string CoreWorkload::COMPRESSIBILITY_PROPERTY = "compressibility";
+const string CoreWorkload::COMPRESSIBILITY_DEFAULT = "1";
+
 const string CoreWorkload::READ_ALL_FIELDS_PROPERTY = "readallfields";
 const string CoreWorkload::READ_ALL_FIELDS_DEFAULT = "true";
 
@@ -71,12 +91,45 @@ const string CoreWorkload::SCAN_PROPORTION_DEFAULT = "0.0";
 const string CoreWorkload::READMODIFYWRITE_PROPORTION_PROPERTY = "readmodifywriteproportion";
 const string CoreWorkload::READMODIFYWRITE_PROPORTION_DEFAULT = "0.0";
 
+const string CoreWorkload::DELETE_PROPORTION_PROPERTY = "deleteproportion";
+const string CoreWorkload::DELETE_PROPORTION_DEFAULT = "0.0";
+
+const string CoreWorkload::DELETE_RUN_LENGTH_PROPERTY = "deleterunlength";
+const string CoreWorkload::DELETE_RUN_LENGTH_DEFAULT = "1";
+
+const string CoreWorkload::REINSERT_PROPORTION_PROPERTY = "reinsertproportion";
+const string CoreWorkload::REINSERT_PROPORTION_DEFAULT = "0.0";
+
+const string CoreWorkload::READ_DELETED_PROPORTION_PROPERTY = "readdeletedproportion";
+const string CoreWorkload::READ_DELETED_PROPORTION_DEFAULT = "0.0";
+
 const string CoreWorkload::REQUEST_DISTRIBUTION_PROPERTY = "requestdistribution";
 const string CoreWorkload::REQUEST_DISTRIBUTION_DEFAULT = "uniform";
 
+const string CoreWorkload::HOTSPOT_DATA_FRACTION_PROPERTY = "hotspotdatafraction";
+const string CoreWorkload::HOTSPOT_DATA_FRACTION_DEFAULT = "0.2";
+
+const string CoreWorkload::HOTSPOT_OPN_FRACTION_PROPERTY = "hotspotopnfraction";
+const string CoreWorkload::HOTSPOT_OPN_FRACTION_DEFAULT = "0.8";
+
+const string CoreWorkload::EXPONENTIAL_PERCENTILE_PROPERTY = "exponential.percentile";
+const string CoreWorkload::EXPONENTIAL_PERCENTILE_DEFAULT = "95";
+
+const string CoreWorkload::EXPONENTIAL_FRAC_PROPERTY = "exponential.frac";
+const string CoreWorkload::EXPONENTIAL_FRAC_DEFAULT = "0.8571428571";
+
+const string CoreWorkload::MOVING_ZIPFIAN_RATE_PROPERTY = "movingzipfian.rate";
+const string CoreWorkload::MOVING_ZIPFIAN_RATE_DEFAULT = "1000";
+
 const string CoreWorkload::ZERO_PADDING_PROPERTY = "zeropadding";
 const string CoreWorkload::ZERO_PADDING_DEFAULT = "1";
 
+const string CoreWorkload::KEY_FORMAT_PROPERTY = "keyformat";
+const string CoreWorkload::KEY_FORMAT_DEFAULT = "decimal";
+
+const string CoreWorkload::KEY_PREFIX_PROPERTY = "keyprefix";
+const string CoreWorkload::KEY_PREFIX_DEFAULT = "user";
+
 const string CoreWorkload::MIN_SCAN_LENGTH_PROPERTY = "minscanlength";
 const string CoreWorkload::MIN_SCAN_LENGTH_DEFAULT = "1";
 
@@ -92,6 +145,12 @@ const string CoreWorkload::INSERT_ORDER_DEFAULT = "hashed";
 const string CoreWorkload::INSERT_START_PROPERTY = "insertstart";
 const string CoreWorkload::INSERT_START_DEFAULT = "0";
 
+const string CoreWorkload::INSERT_KEY_BLOCK_PROPERTY = "insertkeyblock";
+const string CoreWorkload::INSERT_KEY_BLOCK_DEFAULT = "1";
+
+const string CoreWorkload::BATCH_SIZE_PROPERTY = "batchsize";
+const string CoreWorkload::BATCH_SIZE_DEFAULT = "1";
+
 const string CoreWorkload::RECORD_COUNT_PROPERTY = "recordcount";
 const string CoreWorkload::OPERATION_COUNT_PROPERTY = "operationcount";
 
@@ -99,15 +158,89 @@ const std::string CoreWorkload::FIELD_NAME_PREFIX = "fieldnameprefix";
 const std::string CoreWorkload::FIELD_NAME_PREFIX_DEFAULT = "field";
 
 const std::string CoreWorkload::ZIPFIAN_CONST_PROPERTY = "zipfian_const";
+const std::string CoreWorkload::ZIPFIAN_ZETA_TOLERANCE_PROPERTY = "zipfian_zeta_tolerance";
+
+namespace {
+  // Arguments of an asynchronous operation, kept alive until it completes
+  struct AsyncOp {
+    std::string key;
+    std::vector<std::string> fields;
+    std::vector<ycsbc::DB::Field> values;
+    std::vector<ycsbc::DB::Field> result;
+    std::vector<std::vector<ycsbc::DB::Field>> scan_result;
+    // the run of keys removed by a delete, and the deletes still running
+    std::vector<uint64_t> key_nums;
+    std::vector<std::string> keys;
+    std::atomic<size_t> pending;
+    std::atomic<bool> failed;
+  };
+
+  // Arguments of the synchronous operations of a client thread, reused across
+  // operations so that their storage is allocated once
+  struct ThreadBuffers {
+    std::string key;
+    std::vector<std::string> fields;
+    std::vector<ycsbc::DB::Field> values;
+    std::vector<ycsbc::DB::Field> result;
+    std::vector<std::vector<ycsbc::DB::Field>> scan_result;
+    std::vector<uint64_t> key_nums;
+    std::vector<std::string> keys;
+    std::vector<std::vector<ycsbc::DB::Field>> batch_values;
+    std::vector<std::vector<ycsbc::DB::Field>> batch_result;
+    // load keys claimed by the thread, as offsets from insertstart
+    uint64_t insert_next = 0;
+    uint64_t insert_end = 0;
+
+    // Resizes the batch buffers to n entries
+    void ResizeBatch(size_t n) {
+      keys.resize(n);
+      batch_values.resize(n);
+    }
+  };
+  thread_local ThreadBuffers buffers;
+
+  // Distinct start offsets of the value pool
+  const size_t kValuePoolSize = 1 << 20;
+} // anonymous
 
 namespace ycsbc {
 
 void CoreWorkload::Init(const utils::Properties &p) {
   table_name_ = p.GetProperty(TABLENAME_PROPERTY,TABLENAME_DEFAULT);
 
+  if (p.ContainsKey(ZIPFIAN_ZETA_TOLERANCE_PROPERTY)) {
+    double tolerance = std::stod(p.GetProperty(ZIPFIAN_ZETA_TOLERANCE_PROPERTY));
+    if (tolerance <= 0) {
+      throw utils::Exception("Zipfian zeta tolerance must be positive");
+    }
+    ZipfianGenerator::SetZetaTolerance(tolerance);
+  }
+
   field_count_ = std::stoi(p.GetProperty(FIELD_COUNT_PROPERTY, FIELD_COUNT_DEFAULT));
   field_prefix_ = p.GetProperty(FIELD_NAME_PREFIX, FIELD_NAME_PREFIX_DEFAULT);
-  field_len_generator_ = GetFieldLenGenerator(p);
+  uint64_t max_field_len;
+  field_len_generator_ = GetFieldLenGenerator(p, "", max_field_len);
+  update_field_len_generator_ = field_len_generator_;
+  for (const string &name : {FIELD_LENGTH_DISTRIBUTION_PROPERTY, FIELD_LENGTH_PROPERTY,
+                             FIELD_LENGTH_HISTOGRAM_PROPERTY}) {
+    if (p.ContainsKey(UPDATE_FIELD_LENGTH_PREFIX + name)) {
+      uint64_t max_update_len;
+      update_field_len_generator_ = GetFieldLenGenerator(p, UPDATE_FIELD_LENGTH_PREFIX, max_update_len);
+      max_field_len = std::max(max_field_len, max_update_len);
+      break;
+    }
+  }
+  for (int i = 0; i < field_count_; i++) {
+    field_names_.push_back(field_prefix_ + std::to_string(i));
+  }
+  double compressibility = std::stod(p.GetProperty(COMPRESSIBILITY_PROPERTY,
+                                                   COMPRESSIBILITY_DEFAULT));
+  if (compressibility < 1) {
+    throw utils::Exception("Compressibility must be at least 1");
+  }
+  // values longer than the pool are copied in pieces
+  value_pool_ = new ValuePool(kValuePoolSize, std::min<uint64_t>(max_field_len, kValuePoolSize),
+                              compressibility);
 
   double read_proportion = std::stod(p.GetProperty(READ_PROPORTION_PROPERTY,
                                                    READ_PROPORTION_DEFAULT));
@@ -119,6 +252,8 @@ void CoreWorkload::Init(const utils::Properties &p) {
                                                    SCAN_PROPORTION_DEFAULT));
   double readmodifywrite_proportion = std::stod(p.GetProperty(
       READMODIFYWRITE_PROPORTION_PROPERTY, READMODIFYWRITE_PROPORTION_DEFAULT));
+  double delete_proportion = std::stod(p.GetProperty(DELETE_PROPORTION_PROPERTY,
+                                                     DELETE_PROPORTION_DEFAULT));
 
   record_count_ = std::stoi(p.GetProperty(RECORD_COUNT_PROPERTY));
   std::string request_dist = p.GetProperty(REQUEST_DISTRIBUTION_PROPERTY,
@@ -127,9 +262,20 @@ void CoreWorkload::Init(const utils::Properties &p) {
   int max_scan_len = std::stoi(p.GetProperty(MAX_SCAN_LENGTH_PROPERTY, MAX_SCAN_LENGTH_DEFAULT));
   std::string scan_len_dist = p.GetProperty(SCAN_LENGTH_DISTRIBUTION_PROPERTY,
                                             SCAN_LENGTH_DISTRIBUTION_DEFAULT);
-  int insert_start = std::stoi(p.GetProperty(INSERT_START_PROPERTY, INSERT_START_DEFAULT));
+  insert_start_ = std::stoull(p.GetProperty(INSERT_START_PROPERTY, INSERT_START_DEFAULT));
+  insert_key_block_ = std::stoi(p.GetProperty(INSERT_KEY_BLOCK_PROPERTY, INSERT_KEY_BLOCK_DEFAULT));
+  if (insert_key_block_ < 1) {
+    throw utils::Exception("Insert key block must be positive: " + std::to_string(insert_key_block_));
+  }
 
   zero_padding_ = std::stoi(p.GetProperty(ZERO_PADDING_PROPERTY, ZERO_PADDING_DEFAULT));
+  key_format_ = ParseKeyFormat(p.GetProperty(KEY_FORMAT_PROPERTY, KEY_FORMAT_DEFAULT));
+  key_prefix_ = p.GetProperty(KEY_PREFIX_PROPERTY, KEY_PREFIX_DEFAULT);
+
+  batch_size_ = std::stoi(p.GetProperty(BATCH_SIZE_PROPERTY, BATCH_SIZE_DEFAULT));
+  if (batch_size_ < 1) {
+    throw utils::Exception("Batch size must be positive: " + std::to_string(batch_size_));
+  }
 
   read_all_fields_ = utils::StrToBool(p.GetProperty(READ_ALL_FIELDS_PROPERTY,
                                                     READ_ALL_FIELDS_DEFAULT));
@@ -158,14 +304,30 @@ void CoreWorkload::Init(const utils::Properties &p) {
   if (readmodifywrite_proportion > 0) {
     op_chooser_.AddValue(READMODIFYWRITE, readmodifywrite_proportion);
   }
+  if (delete_proportion > 0) {
+    op_chooser_.AddValue(DELETE, delete_proportion);
+    // every key a transaction can choose: the loaded ones and one per insert
+    uint64_t op_count = std::stoull(p.GetProperty(OPERATION_COUNT_PROPERTY, "0"));
+    deleted_keys_ = new DeletedKeyTracker(record_count_ + op_count);
+    delete_run_length_ = std::stoi(p.GetProperty(DELETE_RUN_LENGTH_PROPERTY,
+                                                 DELETE_RUN_LENGTH_DEFAULT));
+    if (delete_run_length_ < 1) {
+      throw utils::Exception("Delete run length must be positive: " +
+                             std::to_string(delete_run_length_));
+    }
+    reinsert_proportion_ = std::stod(p.GetProperty(REINSERT_PROPORTION_PROPERTY,
+                                                   REINSERT_PROPORTION_DEFAULT));
+    read_deleted_proportion_ = std::stod(p.GetProperty(READ_DELETED_PROPORTION_PROPERTY,
+                                                       READ_DELETED_PROPORTION_DEFAULT));
+  }
 
-  insert_key_sequence_ = new CounterGenerator(insert_start);
+  insert_key_sequence_ = new CounterGenerator(insert_start_);
   transaction_insert_key_sequence_ = new AcknowledgedCounterGenerator(record_count_);
 
   if (request_dist == "uniform") {
     key_chooser_ = new UniformGenerator(0, record_count_ - 1);
 
-  } else if (request_dist == "zipfian") {
+  } else if (request_dist == "zipfian" || request_dist == "movingzipfian") {
     // If the number of keys changes, we don't want to change popular keys.
     // So we construct the scrambled zipfian generator with a keyspace
     // that is larger than what exists at the beginning of the test.
@@ -173,14 +335,41 @@ void CoreWorkload::Init(const utils::Properties &p) {
     // and pick another key.
     int op_count = std::stoi(p.GetProperty(OPERATION_COUNT_PROPERTY));
     int new_keys = (int)(op_count * insert_proportion * 2); // a fudge factor
-    if (p.ContainsKey(ZIPFIAN_CONST_PROPERTY)) {
-      double zipfian_const = std::stod(p.GetProperty(ZIPFIAN_CONST_PROPERTY));
-      key_chooser_ = new ScrambledZipfianGenerator(0, record_count_ + new_keys - 1, zipfian_const);
+    double zipfian_const = p.ContainsKey(ZIPFIAN_CONST_PROPERTY) ?
+                           std::stod(p.GetProperty(ZIPFIAN_CONST_PROPERTY)) :
+                           ZipfianGenerator::kZipfianConst;
+    if (request_dist == "movingzipfian") {
+      double rate = std::stod(p.GetProperty(MOVING_ZIPFIAN_RATE_PROPERTY,
+                                            MOVING_ZIPFIAN_RATE_DEFAULT));
+      key_chooser_ = new MovingZipfianGenerator(0, record_count_ + new_keys - 1, zipfian_const,
+                                                rate);
     } else {
-      key_chooser_ = new ScrambledZipfianGenerator(record_count_ + new_keys);
+      key_chooser_ = new ScrambledZipfianGenerator(0, record_count_ + new_keys - 1, zipfian_const);
     }
   } else if (request_dist == "latest") {
     key_chooser_ = new SkewedLatestGenerator(*transaction_insert_key_sequence_);
+
+  } else if (request_dist == "hotspot") {
+    double hot_set_fraction = std::stod(p.GetProperty(HOTSPOT_DATA_FRACTION_PROPERTY,
+                                                      HOTSPOT_DATA_FRACTION_DEFAULT));
+    double hot_op_fraction = std::stod(p.GetProperty(HOTSPOT_OPN_FRACTION_PROPERTY,
+                                                     HOTSPOT_OPN_FRACTION_DEFAULT));
+    if (hot_set_fraction < 0 || hot_set_fraction > 1 || hot_op_fraction < 0 || hot_op_fraction > 1) {
+      throw utils::Exception("Hotspot fractions must be between 0 and 1");
+    }
+    key_chooser_ = new HotspotGenerator(0, record_count_ - 1, hot_set_fraction, hot_op_fraction);
+
+  } else if (request_dist == "sequential") {
+    key_chooser_ = new SequentialGenerator(0, record_count_ - 1);
+
+  } else if (request_dist == "exponential") {
+    double percentile = std::stod(p.GetProperty(EXPONENTIAL_PERCENTILE_PROPERTY,
+                                                EXPONENTIAL_PERCENTILE_DEFAULT));
+    double frac = std::stod(p.GetProperty(EXPONENTIAL_FRAC_PROPERTY, EXPONENTIAL_FRAC_DEFAULT));
+    if (percentile <= 0 || percentile >= 100 || frac <= 0) {
+      throw utils::Exception("Exponential percentile must be between 0 and 100, and frac positive");
+    }
+    key_chooser_ = new ExponentialGenerator(percentile, record_count_ * frac);
   } else {
     throw utils::Exception("Unknown request distribution: " + request_dist);
   }
@@ -197,11 +386,24 @@ void CoreWorkload::Init(const utils::Properties &p) {
 }
 
 ycsbc::Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator(
-    const utils::Properties &p) {
-  string field_len_dist = p.GetProperty(FIELD_LENGTH_DISTRIBUTION_PROPERTY,
-                                        FIELD_LENGTH_DISTRIBUTION_DEFAULT);
-  int field_len = std::stoi(p.GetProperty(FIELD_LENGTH_PROPERTY, FIELD_LENGTH_DEFAULT));
-  if(field_len_dist == "constant") {
+    const utils::Properties &p, const string &prefix, uint64_t &max_len) {
+  auto property = [&p, &prefix](const string &name, const string &default_value) {
+    return p.GetProperty(prefix + name, p.GetProperty(name, default_value));
+  };
+  string field_len_dist = property(FIELD_LENGTH_DISTRIBUTION_PROPERTY,
+                                   FIELD_LENGTH_DISTRIBUTION_DEFAULT);
+  int field_len = std::stoi(property(FIELD_LENGTH_PROPERTY, FIELD_LENGTH_DEFAULT));
+  max_len = field_len;
+  if(field_len_dist == "histogram") {
+    string path = property(FIELD_LENGTH_HISTOGRAM_PROPERTY, "");
+    if (path == "") {
+      throw utils::Exception("The histogram field length distribution needs " +
+                             prefix + FIELD_LENGTH_HISTOGRAM_PROPERTY);
+    }
+    HistogramGenerator *generator = new HistogramGenerator(path);
+    max_len = generator->max();
+    return generator;
+  } else if(field_len_dist == "constant") {
     return new ConstGenerator(field_len);
   } else if(field_len_dist == "uniform") {
     return new UniformGenerator(1, field_len);
@@ -213,148 +415,531 @@ ycsbc::Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator(
 }
 
 std::string CoreWorkload::BuildKeyName(uint64_t key_num) {
+  return KeyNameFromValue(KeyNameValue(key_num));
+}
+
+void CoreWorkload::BuildKeyName(uint64_t key_num, std::string &key) {
+  KeyNameFromValue(KeyNameValue(key_num), key);
+}
+
+uint64_t CoreWorkload::KeyNameValue(uint64_t key_num) {
   if (!ordered_inserts_) {
     key_num = utils::Hash(key_num);
   }
-  std::string prekey = "user";
-  std::string value = std::to_string(key_num);
-  int fill = std::max(0, zero_padding_ - static_cast<int>(value.size()));
-  return prekey.append(fill, '0').append(value);
+  return key_num;
+}
+
+std::string CoreWorkload::KeyNameFromValue(uint64_t key_value) {
+  std::string key;
+  KeyNameFromValue(key_value, key);
+  return key;
+}
+
+void CoreWorkload::KeyNameFromValue(uint64_t key_value, std::string &key) {
+  key.assign(key_prefix_);
+  switch (key_format_) {
+    case kBinaryKey: {
+      char bytes[8];
+      for (int i = 7; i >= 0; i--) {
+        bytes[i] = static_cast<char>(key_value);
+        key_value >>= 8;
+      }
+      key.append(bytes, sizeof(bytes));
+      break;
+    }
+    case kHexKey: {
+      static const char kHexDigits[] = "0123456789abcdef";
+      char digits[16];
+      for (int i = 15; i >= 0; i--) {
+        digits[i] = kHexDigits[key_value & 0xf];
+        key_value >>= 4;
+      }
+      key.append(digits, sizeof(digits));
+      break;
+    }
+    case kDecimalKey: {
+      char digits[20];
+      char *end = std::to_chars(digits, digits + sizeof(digits), key_value).ptr;
+      int len = end - digits;
+      int fill = std::max(0, zero_padding_ - len);
+      key.append(fill, '0').append(digits, len);
+      break;
+    }
+  }
+}
+
+CoreWorkload::KeyFormat CoreWorkload::ParseKeyFormat(const std::string &name) {
+  if (name == "decimal") {
+    return kDecimalKey;
+  } else if (name == "hex") {
+    return kHexKey;
+  } else if (name == "binary") {
+    return kBinaryKey;
+  } else {
+    throw utils::Exception("Unknown key format: " + name);
+  }
+}
+
+std::vector<uint64_t> CoreWorkload::SortedLoadKeys(uint64_t count) {
+  std::vector<uint64_t> keys(count);
+  for (uint64_t i = 0; i < count; i++) {
+    keys[i] = KeyNameValue(insert_start_ + i);
+  }
+  if (key_format_ != kDecimalKey) {
+    // fixed width names sort as their values
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+  }
+  // Orders the values as their zero padded decimal strings, without building them
+  auto digits = [this](uint64_t v) {
+    int n = 1;
+    while (v >= 10) {
+      v /= 10;
+      n++;
+    }
+    return std::max(n, zero_padding_);
+  };
+  auto pow10 = [](int n) {
+    uint64_t p = 1;
+    while (n-- > 0) {
+      p *= 10;
+    }
+    return p;
+  };
+  std::sort(keys.begin(), keys.end(), [&](uint64_t a, uint64_t b) {
+    int len_a = digits(a);
+    int len_b = digits(b);
+    if (len_a == len_b) {
+      return a < b;
+    }
+    // the longer name has no padding, so compare the shorter one with its prefix
+    if (len_a < len_b) {
+      return a <= b / pow10(len_b - len_a);
+    } else {
+      return a / pow10(len_a - len_b) < b;
+    }
+  });
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  return keys;
 }
 
 void CoreWorkload::BuildValues(std::vector<ycsbc::DB::Field> &values) {
+  BuildValues(values, *field_len_generator_);
+}
+
+void CoreWorkload::BuildUpdateValues(std::vector<ycsbc::DB::Field> &values) {
+  BuildValues(values, *update_field_len_generator_);
+}
+
+void CoreWorkload::BuildValues(std::vector<ycsbc::DB::Field> &values,
+                               Generator<uint64_t> &field_len_generator) {
+  values.resize(field_count_);
   for (int i = 0; i < field_count_; ++i) {
-    values.push_back(DB::Field());
-    ycsbc::DB::Field &field = values.back();
-    field.name.append(field_prefix_).append(std::to_string(i));
-    uint64_t len = field_len_generator_->Next();
-    field.value.reserve(len);
-    RandomByteGenerator byte_generator;
-    std::generate_n(std::back_inserter(field.value), len, [&]() { return byte_generator.Next(); } );
+    ycsbc::DB::Field &field = values[i];
+    field.name.assign(field_names_[i]);
+    value_pool_->Fill(field.value, field_len_generator.Next());
   }
 }
 
-void CoreWorkload::BuildSingleValue(std::vector<ycsbc::DB::Field> &values) {
-  values.push_back(DB::Field());
-  ycsbc::DB::Field &field = values.back();
-  field.name.append(NextFieldName());
-  uint64_t len = field_len_generator_->Next();
-  field.value.reserve(len);
-  RandomByteGenerator byte_generator;
-  std::generate_n(std::back_inserter(field.value), len, [&]() { return byte_generator.Next(); } );
+int CoreWorkload::BuildSingleValue(std::vector<ycsbc::DB::Field> &values) {
+  int index = NextField();
+  values.resize(1);
+  ycsbc::DB::Field &field = values[0];
+  field.name.assign(field_names_[index]);
+  value_pool_->Fill(field.value, update_field_len_generator_->Next());
+  return index;
 }
 
 uint64_t CoreWorkload::NextTransactionKeyNum() {
+  // give up avoiding deleted keys if nearly all chosen keys are deleted
+  const int kMaxDeletedKeyRetries = 16;
   uint64_t key_num;
+  int deleted_retries = 0;
   do {
     key_num = key_chooser_->Next();
-  } while (key_num > transaction_insert_key_sequence_->Last());
+  } while (key_num > transaction_insert_key_sequence_->Last() ||
+           (deleted_keys_ != nullptr && deleted_keys_->IsDeleted(key_num) &&
+            ++deleted_retries < kMaxDeletedKeyRetries));
   return key_num;
 }
 
-std::string CoreWorkload::NextFieldName() {
-  return std::string(field_prefix_).append(std::to_string(field_chooser_->Next()));
+bool CoreWorkload::NextReinsertKeyNum(uint64_t &key_num) {
+  return reinsert_proportion_ > 0 &&
+         utils::ThreadRandom().NextDouble() < reinsert_proportion_ &&
+         deleted_keys_->TakeRandom(key_num);
+}
+
+uint64_t CoreWorkload::NextReadKeyNum() {
+  uint64_t key_num;
+  if (read_deleted_proportion_ > 0 &&
+      utils::ThreadRandom().NextDouble() < read_deleted_proportion_ &&
+      deleted_keys_->PeekRandom(key_num)) {
+    return key_num;
+  }
+  return NextTransactionKeyNum();
+}
+
+int CoreWorkload::NextField() {
+  return field_chooser_->Next();
+}
+
+void CoreWorkload::ClaimInsertKeys(uint64_t first, uint64_t count) {
+  if (insert_key_block_ > 1) {
+    buffers.insert_next = first;
+    buffers.insert_end = first + count;
+  }
+}
+
+uint64_t CoreWorkload::NextInsertKeyNum() {
+  if (buffers.insert_next < buffers.insert_end) {
+    return insert_start_ + buffers.insert_next++;
+  }
+  return insert_key_sequence_->Next();
 }
 
 bool CoreWorkload::DoInsert(DB &db) {
-  const std::string key = BuildKeyName(insert_key_sequence_->Next());
-  std::vector<DB::Field> fields;
-  BuildValues(fields);
-  return db.Insert(table_name_, key, fields) == DB::kOK;
+  BuildKeyName(NextInsertKeyNum(), buffers.key);
+  BuildValues(buffers.values);
+  return db.Insert(table_name_, buffers.key, buffers.values) == DB::kOK;
+}
+
+bool CoreWorkload::DoBatchInsert(DB &db, int count) {
+  buffers.ResizeBatch(count);
+  for (int i = 0; i < count; ++i) {
+    BuildKeyName(NextInsertKeyNum(), buffers.keys[i]);
+    BuildValues(buffers.batch_values[i]);
+  }
+  return db.BatchInsert(table_name_, buffers.keys, buffers.batch_values) == DB::kOK;
+}
+
+bool CoreWorkload::DoBulkInsert(DB &db, const uint64_t *keys, size_t count) {
+  buffers.ResizeBatch(count);
+  for (size_t i = 0; i < count; ++i) {
+    KeyNameFromValue(keys[i], buffers.keys[i]);
+    BuildValues(buffers.batch_values[i]);
+  }
+  return db.BulkInsert(table_name_, buffers.keys, buffers.batch_values) == DB::kOK;
 }
 
 bool CoreWorkload::DoTransaction(DB &db) {
-  DB::Status status;
+  int keys;
+  return NextTransaction(db, batch_size_, keys) == DB::kOK;
+}
+
+int CoreWorkload::DoBatchTransaction(DB &db, int count) {
+  int keys;
+  NextTransaction(db, count, keys);
+  return keys;
+}
+
+DB::Status CoreWorkload::NextTransaction(DB &db, int count, int &keys) {
+  keys = 1;
   switch (op_chooser_.Next()) {
     case READ:
-      status = TransactionRead(db);
-      break;
+      if (batch_size_ > 1) {
+        keys = count;
+        return TransactionBatchRead(db, count);
+      }
+      return TransactionRead(db);
     case UPDATE:
-      status = TransactionUpdate(db);
-      break;
+      if (batch_size_ > 1) {
+        keys = count;
+        return TransactionBatchUpdate(db, count);
+      }
+      return TransactionUpdate(db);
     case INSERT:
-      status = TransactionInsert(db);
-      break;
+      if (batch_size_ > 1) {
+        keys = count;
+        return TransactionBatchInsert(db, count);
+      }
+      return TransactionInsert(db);
     case SCAN:
-      status = TransactionScan(db);
-      break;
+      return TransactionScan(db);
     case READMODIFYWRITE:
-      status = TransactionReadModifyWrite(db);
+      return TransactionReadModifyWrite(db);
+    case DELETE:
+      return TransactionDelete(db);
+    default:
+      throw utils::Exception("Operation request is not recognized!");
+  }
+}
+
+void CoreWorkload::DoInsertAsync(DB &db, std::function<void(bool)> done) {
+  auto op = std::make_shared<AsyncOp>();
+  BuildKeyName(NextInsertKeyNum(), op->key);
+  BuildValues(op->values);
+  db.InsertAsync(table_name_, op->key, op->values, [op, done](DB::Status s) {
+    done(s == DB::kOK);
+  });
+}
+
+void CoreWorkload::DoTransactionAsync(DB &db, std::function<void(bool)> done) {
+  auto op = std::make_shared<AsyncOp>();
+  auto complete = [op, done](DB::Status s) { done(s == DB::kOK); };
+  switch (op_chooser_.Next()) {
+    case READ: {
+      uint64_t key_num = NextReadKeyNum();
+      BuildKeyName(key_num, op->key);
+      int field = read_all_fields() ? -1 : NextField();
+      if (field >= 0) {
+        op->fields.push_back(field_names_[field]);
+      }
+      Trace(READ, key_num, field);
+      db.ReadAsync(table_name_, op->key, read_all_fields() ? nullptr : &op->fields, op->result,
+                   complete);
+      break;
+    }
+    case UPDATE: {
+      uint64_t key_num = NextTransactionKeyNum();
+      BuildKeyName(key_num, op->key);
+      int field = -1;
+      if (write_all_fields()) {
+        BuildUpdateValues(op->values);
+      } else {
+        field = BuildSingleValue(op->values);
+      }
+      Trace(UPDATE, key_num, field, op->values);
+      db.UpdateAsync(table_name_, op->key, op->values, complete);
+      break;
+    }
+    case INSERT: {
+      uint64_t key_num;
+      bool reinsert = NextReinsertKeyNum(key_num);
+      if (!reinsert) {
+        key_num = transaction_insert_key_sequence_->Next();
+      }
+      BuildKeyName(key_num, op->key);
+      BuildValues(op->values);
+      Trace(INSERT, key_num, -1, op->values);
+      db.InsertAsync(table_name_, op->key, op->values,
+                     [this, op, done, key_num, reinsert](DB::Status s) {
+        if (reinsert) {
+          deleted_keys_->MarkLive(key_num);
+        } else {
+          transaction_insert_key_sequence_->Acknowledge(key_num);
+        }
+        done(s == DB::kOK);
+      });
+      break;
+    }
+    case SCAN: {
+      uint64_t key_num = NextReadKeyNum();
+      BuildKeyName(key_num, op->key);
+      int len = scan_len_chooser_->Next();
+      int field = read_all_fields() ? -1 : NextField();
+      if (field >= 0) {
+        op->fields.push_back(field_names_[field]);
+      }
+      Trace(SCAN, key_num, field, len);
+      db.ScanAsync(table_name_, op->key, len, read_all_fields() ? nullptr : &op->fields,
+                   op->scan_result, complete);
       break;
+    }
+    case READMODIFYWRITE: {
+      uint64_t key_num = NextTransactionKeyNum();
+      BuildKeyName(key_num, op->key);
+      if (!read_all_fields()) {
+        op->fields.push_back(field_names_[NextField()]);
+      }
+      int field = -1;
+      if (write_all_fields()) {
+        BuildUpdateValues(op->values);
+      } else {
+        field = BuildSingleValue(op->values);
+      }
+      Trace(READMODIFYWRITE, key_num, field, op->values);
+      DB *dbp = &db;
+      db.ReadAsync(table_name_, op->key, read_all_fields() ? nullptr : &op->fields, op->result,
+                   [this, dbp, op, complete](DB::Status) {
+        dbp->UpdateAsync(table_name_, op->key, op->values, complete);
+      });
+      break;
+    }
+    case DELETE: {
+      uint64_t key_num = NextTransactionKeyNum();
+      uint64_t last = transaction_insert_key_sequence_->Last();
+      for (uint64_t k = key_num; k < key_num + delete_run_length_ && k <= last; k++) {
+        if (k == key_num || !deleted_keys_->IsDeleted(k)) {
+          Trace(DELETE, k, -1);
+          op->key_nums.push_back(k);
+          op->keys.push_back(BuildKeyName(k));
+        }
+      }
+      op->pending = op->keys.size();
+      op->failed = false;
+      for (size_t i = 0; i < op->keys.size(); i++) {
+        db.DeleteAsync(table_name_, op->keys[i], [this, op, done, i](DB::Status s) {
+          if (s == DB::kOK) {
+            deleted_keys_->MarkDeleted(op->key_nums[i]);
+          } else {
+            op->failed = true;
+          }
+          if (--op->pending == 0) {
+            done(!op->failed);
+          }
+        });
+      }
+      break;
+    }
     default:
       throw utils::Exception("Operation request is not recognized!");
   }
-  return (status == DB::kOK);
 }
 
 DB::Status CoreWorkload::TransactionRead(DB &db) {
-  uint64_t key_num = NextTransactionKeyNum();
-  const std::string key = BuildKeyName(key_num);
-  std::vector<DB::Field> result;
+  uint64_t key_num = NextReadKeyNum();
+  BuildKeyName(key_num, buffers.key);
+  buffers.result.clear();
   if (!read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back(NextFieldName());
-    return db.Read(table_name_, key, &fields, result);
+    int field = NextField();
+    Trace(READ, key_num, field);
+    buffers.fields.assign(1, field_names_[field]);
+    return db.Read(table_name_, buffers.key, &buffers.fields, buffers.result);
   } else {
-    return db.Read(table_name_, key, NULL, result);
+    Trace(READ, key_num, -1);
+    return db.Read(table_name_, buffers.key, NULL, buffers.result);
   }
 }
 
 DB::Status CoreWorkload::TransactionReadModifyWrite(DB &db) {
   uint64_t key_num = NextTransactionKeyNum();
-  const std::string key = BuildKeyName(key_num);
-  std::vector<DB::Field> result;
+  BuildKeyName(key_num, buffers.key);
+  buffers.result.clear();
 
   if (!read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back(NextFieldName());
-    db.Read(table_name_, key, &fields, result);
+    buffers.fields.assign(1, field_names_[NextField()]);
+    db.Read(table_name_, buffers.key, &buffers.fields, buffers.result);
   } else {
-    db.Read(table_name_, key, NULL, result);
+    db.Read(table_name_, buffers.key, NULL, buffers.result);
   }
 
-  std::vector<DB::Field> values;
+  int field = -1;
   if (write_all_fields()) {
-    BuildValues(values);
+    BuildUpdateValues(buffers.values);
   } else {
-    BuildSingleValue(values);
+    field = BuildSingleValue(buffers.values);
   }
-  return db.Update(table_name_, key, values);
+  Trace(READMODIFYWRITE, key_num, field, buffers.values);
+  return db.Update(table_name_, buffers.key, buffers.values);
 }
 
 DB::Status CoreWorkload::TransactionScan(DB &db) {
-  uint64_t key_num = NextTransactionKeyNum();
-  const std::string key = BuildKeyName(key_num);
+  uint64_t key_num = NextReadKeyNum();
+  BuildKeyName(key_num, buffers.key);
   int len = scan_len_chooser_->Next();
-  std::vector<std::vector<DB::Field>> result;
+  buffers.scan_result.clear();
   if (!read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back(NextFieldName());
-    return db.Scan(table_name_, key, len, &fields, result);
+    int field = NextField();
+    Trace(SCAN, key_num, field, len);
+    buffers.fields.assign(1, field_names_[field]);
+    return db.Scan(table_name_, buffers.key, len, &buffers.fields, buffers.scan_result);
   } else {
-    return db.Scan(table_name_, key, len, NULL, result);
+    Trace(SCAN, key_num, -1, len);
+    return db.Scan(table_name_, buffers.key, len, NULL, buffers.scan_result);
   }
 }
 
 DB::Status CoreWorkload::TransactionUpdate(DB &db) {
   uint64_t key_num = NextTransactionKeyNum();
-  const std::string key = BuildKeyName(key_num);
-  std::vector<DB::Field> values;
+  BuildKeyName(key_num, buffers.key);
+  int field = -1;
   if (write_all_fields()) {
-    BuildValues(values);
+    BuildUpdateValues(buffers.values);
   } else {
-    BuildSingleValue(values);
+    field = BuildSingleValue(buffers.values);
   }
-  return db.Update(table_name_, key, values);
+  Trace(UPDATE, key_num, field, buffers.values);
+  return db.Update(table_name_, buffers.key, buffers.values);
 }
 
 DB::Status CoreWorkload::TransactionInsert(DB &db) {
-  uint64_t key_num = transaction_insert_key_sequence_->Next();
-  const std::string key = BuildKeyName(key_num);
-  std::vector<DB::Field> values;
-  BuildValues(values);
-  DB::Status s = db.Insert(table_name_, key, values);
-  transaction_insert_key_sequence_->Acknowledge(key_num);
+  uint64_t key_num;
+  bool reinsert = NextReinsertKeyNum(key_num);
+  if (!reinsert) {
+    key_num = transaction_insert_key_sequence_->Next();
+  }
+  BuildKeyName(key_num, buffers.key);
+  BuildValues(buffers.values);
+  Trace(INSERT, key_num, -1, buffers.values);
+  DB::Status s = db.Insert(table_name_, buffers.key, buffers.values);
+  if (reinsert) {
+    deleted_keys_->MarkLive(key_num);
+  } else {
+    transaction_insert_key_sequence_->Acknowledge(key_num);
+  }
+  return s;
+}
+
+DB::Status CoreWorkload::TransactionDelete(DB &db) {
+  uint64_t key_num = NextTransactionKeyNum();
+  uint64_t last = transaction_insert_key_sequence_->Last();
+  DB::Status status = DB::kOK;
+  for (uint64_t k = key_num; k < key_num + delete_run_length_ && k <= last; k++) {
+    if (k != key_num && deleted_keys_->IsDeleted(k)) {
+      continue;
+    }
+    BuildKeyName(k, buffers.key);
+    Trace(DELETE, k, -1);
+    DB::Status s = db.Delete(table_name_, buffers.key);
+    if (s == DB::kOK) {
+      deleted_keys_->MarkDeleted(k);
+    } else {
+      status = s;
+    }
+  }
+  return status;
+}
+
+DB::Status CoreWorkload::TransactionBatchRead(DB &db, int count) {
+  buffers.ResizeBatch(count);
+  buffers.key_nums.resize(count);
+  for (int i = 0; i < count; ++i) {
+    buffers.key_nums[i] = NextReadKeyNum();
+    BuildKeyName(buffers.key_nums[i], buffers.keys[i]);
+  }
+  buffers.batch_result.clear();
+  int field = read_all_fields() ? -1 : NextField();
+  for (uint64_t key_num : buffers.key_nums) {
+    Trace(READ, key_num, field);
+  }
+  if (!read_all_fields()) {
+    buffers.fields.assign(1, field_names_[field]);
+    return db.BatchRead(table_name_, buffers.keys, &buffers.fields, buffers.batch_result);
+  } else {
+    return db.BatchRead(table_name_, buffers.keys, NULL, buffers.batch_result);
+  }
+}
+
+DB::Status CoreWorkload::TransactionBatchUpdate(DB &db, int count) {
+  buffers.ResizeBatch(count);
+  for (int i = 0; i < count; ++i) {
+    uint64_t key_num = NextTransactionKeyNum();
+    BuildKeyName(key_num, buffers.keys[i]);
+    int field = -1;
+    if (write_all_fields()) {
+      BuildUpdateValues(buffers.batch_values[i]);
+    } else {
+      field = BuildSingleValue(buffers.batch_values[i]);
+    }
+    Trace(UPDATE, key_num, field, buffers.batch_values[i]);
+  }
+  return db.BatchUpdate(table_name_, buffers.keys, buffers.batch_values);
+}
+
+DB::Status CoreWorkload::TransactionBatchInsert(DB &db, int count) {
+  buffers.ResizeBatch(count);
+  buffers.key_nums.resize(count);
+  for (int i = 0; i < count; ++i) {
+    buffers.key_nums[i] = transaction_insert_key_sequence_->Next();
+    BuildKeyName(buffers.key_nums[i], buffers.keys[i]);
+    BuildValues(buffers.batch_values[i]);
+    Trace(INSERT, buffers.key_nums[i], -1, buffers.batch_values[i]);
+  }
+  DB::Status s = db.BatchInsert(table_name_, buffers.keys, buffers.batch_values);
+  for (uint64_t key_num : buffers.key_nums) {
+    transaction_insert_key_sequence_->Acknowledge(key_num);
+  }
   return s;
 }
 
@@ -10,6 +10,7 @@
 #ifndef YCSB_C_CORE_WORKLOAD_H_
 #define YCSB_C_CORE_WORKLOAD_H_
 
+#include <functional>
 #include <vector>
 #include <string>
 #include "db.h"
@@ -17,6 +18,9 @@
 #include "discrete_generator.h"
 #include "counter_generator.h"
 #include "acknowledged_counter_generator.h"
+#include "deleted_key_tracker.h"
+#include "trace_writer.h"
+#include "value_pool.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
@@ -29,19 +33,40 @@ enum Operation {
   SCAN,
   READMODIFYWRITE,
   DELETE,
+  BATCH_READ,
+  BATCH_UPDATE,
+  BATCH_INSERT,
   INSERT_FAILED,
   READ_FAILED,
   UPDATE_FAILED,
   SCAN_FAILED,
   READMODIFYWRITE_FAILED,
   DELETE_FAILED,
+  BATCH_READ_FAILED,
+  BATCH_UPDATE_FAILED,
+  BATCH_INSERT_FAILED,
   MAXOPTYPE
 };
 
 extern const char *kOperationString[MAXOPTYPE];
 
+///
+/// Batch operations are reported once per batch, with the number of keys it
+/// covered.
+///
+inline bool IsBatchOperation(Operation op) {
+  return (op >= BATCH_READ && op <= BATCH_INSERT)
+         || (op >= BATCH_READ_FAILED && op <= BATCH_INSERT_FAILED);
+}
+
 class CoreWorkload {
  public:
+  enum KeyFormat {
+    kDecimalKey,
+    kHexKey,
+    kBinaryKey
+  };
+
   ///
   /// The name of the database table to run queries against.
   ///
@@ -56,7 +81,8 @@ class CoreWorkload {
 
   ///
   /// The name of the property for the field length distribution.
-  /// Options are "uniform", "zipfian" (favoring short records), and "constant".
+  /// Options are "uniform", "zipfian" (favoring short records), "constant",
+  /// and "histogram" (read from the file of FIELD_LENGTH_HISTOGRAM_PROPERTY).
   ///
   static const std::string FIELD_LENGTH_DISTRIBUTION_PROPERTY;
   static const std::string FIELD_LENGTH_DISTRIBUTION_DEFAULT;
@@ -67,6 +93,25 @@ class CoreWorkload {
   static const std::string FIELD_LENGTH_PROPERTY;
   static const std::string FIELD_LENGTH_DEFAULT;
 
+  ///
+  /// The name of the property for the file of the "histogram" field length
+  /// distribution, with "length weight" or "min max weight" per line.
+  ///
+  static const std::string FIELD_LENGTH_HISTOGRAM_PROPERTY;
+
+  ///
+  /// The prefix of the field length properties that apply to updates only.
+  /// Without any of them, updates write fields of the insert lengths.
+  ///
+  static const std::string UPDATE_FIELD_LENGTH_PREFIX;
+
+  ///
+  /// The name of the property for the ratio that field values compress by,
+  /// 1 for values of random bytes only.
+  ///
+  static const std::string COMPRESSIBILITY_PROPERTY;
+  static const std::string COMPRESSIBILITY_DEFAULT;
+
   ///
   /// The name of the property for deciding whether to read one field (false)
   /// or all fields (true) of a record.
@@ -112,19 +157,87 @@ class CoreWorkload {
   static const std::string READMODIFYWRITE_PROPORTION_PROPERTY;
   static const std::string READMODIFYWRITE_PROPORTION_DEFAULT;
 
+  ///
+  /// The name of the property for the proportion of delete transactions.
+  ///
+  static const std::string DELETE_PROPORTION_PROPERTY;
+  static const std::string DELETE_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the number of consecutive keys removed
+  /// by one delete transaction, leaving ranges of tombstones behind.
+  ///
+  static const std::string DELETE_RUN_LENGTH_PROPERTY;
+  static const std::string DELETE_RUN_LENGTH_DEFAULT;
+
+  ///
+  /// The name of the property for the proportion of insert transactions
+  /// that reinsert a deleted key rather than a new one.
+  ///
+  static const std::string REINSERT_PROPORTION_PROPERTY;
+  static const std::string REINSERT_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the proportion of read and scan
+  /// transactions that start at a deleted key. Otherwise deleted keys
+  /// are avoided.
+  ///
+  static const std::string READ_DELETED_PROPORTION_PROPERTY;
+  static const std::string READ_DELETED_PROPORTION_DEFAULT;
+
   ///
   /// The name of the property for the the distribution of request keys.
-  /// Options are "uniform", "zipfian" and "latest".
+  /// Options are "uniform", "zipfian", "latest", "hotspot", "sequential",
+  /// "exponential" and "movingzipfian".
   ///
   static const std::string REQUEST_DISTRIBUTION_PROPERTY;
   static const std::string REQUEST_DISTRIBUTION_DEFAULT;
 
+  ///
+  /// The names of the properties for the share of the keys that is hot,
+  /// and the share of the operations on them, for the hotspot distribution.
+  ///
+  static const std::string HOTSPOT_DATA_FRACTION_PROPERTY;
+  static const std::string HOTSPOT_DATA_FRACTION_DEFAULT;
+  static const std::string HOTSPOT_OPN_FRACTION_PROPERTY;
+  static const std::string HOTSPOT_OPN_FRACTION_DEFAULT;
+
+  ///
+  /// The names of the properties for the exponential distribution: the
+  /// given percentile of the operations access the first frac of the keys.
+  ///
+  static const std::string EXPONENTIAL_PERCENTILE_PROPERTY;
+  static const std::string EXPONENTIAL_PERCENTILE_DEFAULT;
+  static const std::string EXPONENTIAL_FRAC_PROPERTY;
+  static const std::string EXPONENTIAL_FRAC_DEFAULT;
+
+  ///
+  /// The name of the property for how many keys per second the hot set
+  /// of the moving zipfian distribution drifts by.
+  ///
+  static const std::string MOVING_ZIPFIAN_RATE_PROPERTY;
+  static const std::string MOVING_ZIPFIAN_RATE_DEFAULT;
+
   ///
   /// The default zero padding value. Matches integer sort order
   ///
   static const std::string ZERO_PADDING_PROPERTY;
   static const std::string ZERO_PADDING_DEFAULT;
 
+  ///
+  /// The name of the property for how key numbers are written after the
+  /// key prefix: "decimal" (zero padded), "hex" (16 digits), or "binary"
+  /// (8 bytes, big-endian). Hex and binary keys sort as their numbers.
+  ///
+  static const std::string KEY_FORMAT_PROPERTY;
+  static const std::string KEY_FORMAT_DEFAULT;
+
+  ///
+  /// The name of the property for the text every key starts with.
+  ///
+  static const std::string KEY_PREFIX_PROPERTY;
+  static const std::string KEY_PREFIX_DEFAULT;
+
   ///
   /// The name of the property for the min scan length (number of records).
   ///
@@ -154,6 +267,21 @@ class CoreWorkload {
   static const std::string INSERT_START_PROPERTY;
   static const std::string INSERT_START_DEFAULT;
 
+  ///
+  /// The name of the property for how many consecutive keys a load thread
+  /// inserts at a time. With 1, the threads take keys one by one from a
+  /// shared counter.
+  ///
+  static const std::string INSERT_KEY_BLOCK_PROPERTY;
+  static const std::string INSERT_KEY_BLOCK_DEFAULT;
+
+  ///
+  /// The name of the property for the number of keys per read, update and
+  /// insert. Values above 1 issue the batch operations of the DB.
+  ///
+  static const std::string BATCH_SIZE_PROPERTY;
+  static const std::string BATCH_SIZE_DEFAULT;
+
   static const std::string RECORD_COUNT_PROPERTY;
   static const std::string OPERATION_COUNT_PROPERTY;
 
@@ -168,6 +296,12 @@ class CoreWorkload {
   ///
   static const std::string ZIPFIAN_CONST_PROPERTY;
 
+  ///
+  /// Bound on the error of the zeta constants of zipfian generators,
+  /// which are approximated beyond the first few items.
+  ///
+  static const std::string ZIPFIAN_ZETA_TOLERANCE_PROPERTY;
+
   ///
   /// Initialize the scenario.
   /// Called once, in the main client thread, before any operations are started.
@@ -177,39 +311,160 @@ class CoreWorkload {
   virtual bool DoInsert(DB &db);
   virtual bool DoTransaction(DB &db);
 
+  ///
+  /// Issues the next transaction, reading, updating or inserting batches of
+  /// at most count keys. Returns the number of keys it covered, so that a
+  /// batch counts as one operation per key, as in the load phase.
+  ///
+  virtual int DoBatchTransaction(DB &db, int count);
+
+  ///
+  /// Inserts the next count records of the load phase as one batch.
+  ///
+  virtual bool DoBatchInsert(DB &db, int count);
+
+  ///
+  /// Returns the keys of the load phase sorted by key name, as values to
+  /// be passed to DoBulkInsert. Duplicate keys are removed.
+  ///
+  std::vector<uint64_t> SortedLoadKeys(uint64_t count);
+  ///
+  /// Inserts the records of count sorted keys from SortedLoadKeys in bulk.
+  /// The records are the same as those written by DoInsert.
+  ///
+  virtual bool DoBulkInsert(DB &db, const uint64_t *keys, size_t count);
+
+  ///
+  /// Asynchronous variants of DoInsert and DoTransaction.
+  /// The done callback is invoked with the result once the operation completes.
+  ///
+  virtual void DoInsertAsync(DB &db, std::function<void(bool)> done);
+  virtual void DoTransactionAsync(DB &db, std::function<void(bool)> done);
+
+  ///
+  /// Returns true once the calling thread has no more transactions to issue,
+  /// as when a replayed trace ends. Generated workloads never run out.
+  ///
+  virtual bool Exhausted() { return false; }
+
   bool read_all_fields() const { return read_all_fields_; }
   bool write_all_fields() const { return write_all_fields_; }
+  int batch_size() const { return batch_size_; }
+  int insert_key_block() const { return insert_key_block_; }
+
+  ///
+  /// Hands the calling thread the count load keys starting at the first'th,
+  /// to insert in order. Ignored unless the load inserts key blocks.
+  ///
+  void ClaimInsertKeys(uint64_t first, uint64_t count);
+
+  ///
+  /// Records the transactions generated from now on with writer, or stops
+  /// recording if it is null. The writer is not owned.
+  ///
+  void set_trace_writer(TraceWriter *writer) { trace_writer_ = writer; }
 
   CoreWorkload() :
       field_count_(0), read_all_fields_(false), write_all_fields_(false),
-      field_len_generator_(nullptr), key_chooser_(nullptr), field_chooser_(nullptr),
+      field_len_generator_(nullptr), update_field_len_generator_(nullptr),
+      key_chooser_(nullptr), field_chooser_(nullptr),
       scan_len_chooser_(nullptr), insert_key_sequence_(nullptr),
-      transaction_insert_key_sequence_(nullptr), ordered_inserts_(true), record_count_(0) {
+      transaction_insert_key_sequence_(nullptr), ordered_inserts_(true), record_count_(0),
+      key_format_(kDecimalKey), insert_start_(0),
+      insert_key_block_(1), batch_size_(1), value_pool_(nullptr), deleted_keys_(nullptr),
+      delete_run_length_(1), reinsert_proportion_(0), read_deleted_proportion_(0),
+      trace_writer_(nullptr) {
   }
 
   virtual ~CoreWorkload() {
+    if (update_field_len_generator_ != field_len_generator_) {
+      delete update_field_len_generator_;
+    }
     delete field_len_generator_;
     delete key_chooser_;
     delete field_chooser_;
     delete scan_len_chooser_;
     delete insert_key_sequence_;
     delete transaction_insert_key_sequence_;
+    delete value_pool_;
+    delete deleted_keys_;
   }
 
  protected:
-  static Generator<uint64_t> *GetFieldLenGenerator(const utils::Properties &p);
+  ///
+  /// Creates the field length generator configured by the properties named
+  /// with prefix, falling back to the unprefixed ones, and sets max_len to
+  /// the longest length it chooses.
+  ///
+  static Generator<uint64_t> *GetFieldLenGenerator(const utils::Properties &p,
+                                                   const std::string &prefix, uint64_t &max_len);
   std::string BuildKeyName(uint64_t key_num);
+  ///
+  /// Writes the key name into key, reusing its storage.
+  ///
+  void BuildKeyName(uint64_t key_num, std::string &key);
+  uint64_t KeyNameValue(uint64_t key_num);
+  std::string KeyNameFromValue(uint64_t value);
+  void KeyNameFromValue(uint64_t value, std::string &key);
+  static KeyFormat ParseKeyFormat(const std::string &name);
+  ///
+  /// Replace the contents of values with all fields, or with one random
+  /// field, reusing the storage of the vector and its strings.
+  ///
   void BuildValues(std::vector<DB::Field> &values);
-  void BuildSingleValue(std::vector<DB::Field> &update);
+  void BuildUpdateValues(std::vector<DB::Field> &values);
+  void BuildValues(std::vector<DB::Field> &values, Generator<uint64_t> &field_len_generator);
+  ///
+  /// Returns the index of the field written by BuildSingleValue.
+  ///
+  int BuildSingleValue(std::vector<DB::Field> &update);
 
+  uint64_t NextInsertKeyNum();
   uint64_t NextTransactionKeyNum();
-  std::string NextFieldName();
+  ///
+  /// Returns the key a read or scan starts at, a deleted one in
+  /// read_deleted_proportion_ of the calls.
+  ///
+  uint64_t NextReadKeyNum();
+  ///
+  /// Takes a deleted key to be reinserted by an insert transaction in
+  /// reinsert_proportion_ of the calls. Returns false for a new key.
+  ///
+  bool NextReinsertKeyNum(uint64_t &key_num);
+  ///
+  /// Returns the index of a field to read or write alone.
+  ///
+  int NextField();
+
+  ///
+  /// Records an operation to the trace, if one is being recorded.
+  /// field is -1 for all fields, size the bytes written or records scanned.
+  ///
+  void Trace(Operation op, uint64_t key_num, int field, uint64_t size = 0) {
+    if (trace_writer_ != nullptr) {
+      trace_writer_->Record(op, key_num, size, field);
+    }
+  }
+  void Trace(Operation op, uint64_t key_num, int field, const std::vector<DB::Field> &values) {
+    if (trace_writer_ != nullptr) {
+      uint64_t size = 0;
+      for (const DB::Field &value : values) {
+        size += value.value.size();
+      }
+      trace_writer_->Record(op, key_num, size, field);
+    }
+  }
 
   DB::Status TransactionRead(DB &db);
   DB::Status TransactionReadModifyWrite(DB &db);
   DB::Status TransactionScan(DB &db);
   DB::Status TransactionUpdate(DB &db);
   DB::Status TransactionInsert(DB &db);
+  DB::Status TransactionDelete(DB &db);
+  DB::Status NextTransaction(DB &db, int count, int &keys);
+  DB::Status TransactionBatchRead(DB &db, int count);
+  DB::Status TransactionBatchUpdate(DB &db, int count);
+  DB::Status TransactionBatchInsert(DB &db, int count);
 
   std::string table_name_;
   int field_count_;
@@ -217,6 +472,7 @@ class CoreWorkload {
   bool read_all_fields_;
   bool write_all_fields_;
   Generator<uint64_t> *field_len_generator_;
+  Generator<uint64_t> *update_field_len_generator_;
   DiscreteGenerator<Operation> op_chooser_;
   Generator<uint64_t> *key_chooser_; // transaction key gen
   Generator<uint64_t> *field_chooser_;
@@ -226,6 +482,18 @@ class CoreWorkload {
   bool ordered_inserts_;
   size_t record_count_;
   int zero_padding_;
+  KeyFormat key_format_;
+  std::string key_prefix_;
+  uint64_t insert_start_;
+  int insert_key_block_;
+  int batch_size_;
+  std::vector<std::string> field_names_;
+  ValuePool *value_pool_;
+  DeletedKeyTracker *deleted_keys_; // null unless the transactions delete
+  int delete_run_length_;
+  double reinsert_proportion_;
+  double read_deleted_proportion_;
+  TraceWriter *trace_writer_;
 };
 
 } // ycsbc
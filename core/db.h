@@ -11,6 +11,7 @@
 
 #include "utils/properties.h"
 
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -100,6 +101,143 @@ class DB {
   ///
   virtual Status Delete(const std::string &table, const std::string &key) = 0;
 
+  ///
+  /// Reads a batch of records from the database.
+  /// The default implementation reads the keys one at a time.
+  ///
+  /// @param table The name of the table.
+  /// @param keys The keys of the records to read.
+  /// @param fields The list of fields to read, or NULL for all of them.
+  /// @param result One vector of field/value pairs per key, in the order of keys.
+  /// @return Zero if every record was read, or the first non-zero error code.
+  ///
+  virtual Status BatchRead(const std::string &table, const std::vector<std::string> &keys,
+                           const std::vector<std::string> *fields,
+                           std::vector<std::vector<Field>> &result) {
+    Status status = kOK;
+    result.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      Status s = Read(table, keys[i], fields, result[i]);
+      if (status == kOK) {
+        status = s;
+      }
+    }
+    return status;
+  }
+  ///
+  /// Updates a batch of records in the database.
+  /// The default implementation updates the keys one at a time.
+  ///
+  /// @param table The name of the table.
+  /// @param keys The keys of the records to write.
+  /// @param values One vector of field/value pairs per key, in the order of keys.
+  /// @return Zero if every record was updated, or the first non-zero error code.
+  ///
+  virtual Status BatchUpdate(const std::string &table, const std::vector<std::string> &keys,
+                             std::vector<std::vector<Field>> &values) {
+    Status status = kOK;
+    for (size_t i = 0; i < keys.size(); i++) {
+      Status s = Update(table, keys[i], values[i]);
+      if (status == kOK) {
+        status = s;
+      }
+    }
+    return status;
+  }
+  ///
+  /// Inserts a batch of records into the database.
+  /// The default implementation inserts the keys one at a time.
+  ///
+  /// @param table The name of the table.
+  /// @param keys The keys of the records to insert.
+  /// @param values One vector of field/value pairs per key, in the order of keys.
+  /// @return Zero if every record was inserted, or the first non-zero error code.
+  ///
+  virtual Status BatchInsert(const std::string &table, const std::vector<std::string> &keys,
+                             std::vector<std::vector<Field>> &values) {
+    Status status = kOK;
+    for (size_t i = 0; i < keys.size(); i++) {
+      Status s = Insert(table, keys[i], values[i]);
+      if (status == kOK) {
+        status = s;
+      }
+    }
+    return status;
+  }
+  ///
+  /// Inserts records in bulk while loading the database.
+  /// The keys are sorted and do not overlap with the keys of any other call.
+  /// The default implementation inserts the records as one batch.
+  ///
+  /// @param table The name of the table.
+  /// @param keys The sorted keys of the records to insert.
+  /// @param values One vector of field/value pairs per key, in the order of keys.
+  /// @return Zero on success, a non-zero error code on error.
+  ///
+  virtual Status BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                            std::vector<std::vector<Field>> &values) {
+    return BatchInsert(table, keys, values);
+  }
+
+  ///
+  /// Saves a consistent copy of the database into the directory dir, which
+  /// does not exist yet. Called on one initialized instance while no
+  /// operations are running.
+  ///
+  /// @param dir The directory to save the copy into.
+  /// @return Zero on success, kNotImplemented if the DB has no snapshot support.
+  ///
+  virtual Status Snapshot(const std::string &dir) {
+    return kNotImplemented;
+  }
+  ///
+  /// Replaces the database with a copy saved by Snapshot.
+  /// Called on one instance before any instance is initialized.
+  ///
+  /// @param dir The directory holding the copy.
+  /// @return Zero on success, kNotImplemented if the DB has no snapshot support.
+  ///
+  virtual Status Restore(const std::string &dir) {
+    return kNotImplemented;
+  }
+
+  ///
+  /// Completion callback of an asynchronous operation.
+  ///
+  using Callback = std::function<void(Status)>;
+  ///
+  /// Asynchronous variants of the operations above.
+  /// The arguments must stay valid until the callback is invoked, which may happen
+  /// on another thread. The default implementations call the synchronous method
+  /// and complete inline.
+  ///
+  virtual void ReadAsync(const std::string &table, const std::string &key,
+                         const std::vector<std::string> *fields,
+                         std::vector<Field> &result, Callback cb) {
+    cb(Read(table, key, fields, result));
+  }
+  virtual void ScanAsync(const std::string &table, const std::string &key,
+                         int record_count, const std::vector<std::string> *fields,
+                         std::vector<std::vector<Field>> &result, Callback cb) {
+    cb(Scan(table, key, record_count, fields, result));
+  }
+  virtual void UpdateAsync(const std::string &table, const std::string &key,
+                           std::vector<Field> &values, Callback cb) {
+    cb(Update(table, key, values));
+  }
+  virtual void InsertAsync(const std::string &table, const std::string &key,
+                           std::vector<Field> &values, Callback cb) {
+    cb(Insert(table, key, values));
+  }
+  virtual void DeleteAsync(const std::string &table, const std::string &key, Callback cb) {
+    cb(Delete(table, key));
+  }
+  ///
+  /// Returns true if the asynchronous operations are natively supported,
+  /// i.e. they return before the operation completes.
+  ///
+  virtual bool NativeAsync() const { return false; }
+
   virtual ~DB() { }
 
   void SetProps(utils::Properties *props) {
@@ -9,6 +9,7 @@
 #include "db_factory.h"
 #include "basic_db.h"
 #include "db_wrapper.h"
+#include "executor_db.h"
 
 namespace ycsbc {
 
@@ -23,6 +24,14 @@ bool DBFactory::RegisterDB(std::string db_name, DBCreator db_creator) {
   return true;
 }
 
+std::vector<std::string> DBFactory::RegisteredDBs() {
+  std::vector<std::string> names;
+  for (const auto &entry : Registry()) {
+    names.push_back(entry.first);
+  }
+  return names;
+}
+
 DB *DBFactory::CreateDB(utils::Properties *props, Measurements *measurements) {
   std::string db_name = props->GetProperty("dbname", "basic");
   DB *db = nullptr;
@@ -30,6 +39,18 @@ DB *DBFactory::CreateDB(utils::Properties *props, Measurements *measurements) {
   if (registry.find(db_name) != registry.end()) {
     DB *new_db = (*registry[db_name])();
     new_db->SetProps(props);
+    // bindings without native async support run on a per-client executor
+    const int queue_depth = std::stoi(props->GetProperty("queuedepth", "1"));
+    if (queue_depth > 1 && !new_db->NativeAsync()) {
+      const int executor_threads = std::stoi(props->GetProperty("async.executor_threads", "4"));
+      std::vector<DB *> dbs{new_db};
+      for (int i = 1; i < executor_threads; i++) {
+        DB *worker_db = (*registry[db_name])();
+        worker_db->SetProps(props);
+        dbs.push_back(worker_db);
+      }
+      new_db = new ExecutorDB(dbs);
+    }
     db = new DBWrapper(new_db, measurements);
   }
   return db;
@@ -15,6 +15,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace ycsbc {
 
@@ -23,6 +24,7 @@ class DBFactory {
   using DBCreator = DB *(*)();
   static bool RegisterDB(std::string db_name, DBCreator db_creator);
   static DB *CreateDB(utils::Properties *props, Measurements *measurements);
+  static std::vector<std::string> RegisteredDBs();
  private:
   static std::map<std::string, DBCreator> &Registry();
 };
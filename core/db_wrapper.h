@@ -13,7 +13,8 @@
 
 #include "db.h"
 #include "measurements.h"
-#include "utils/timer.h"
+#include "utils/arrival.h"
+#include "utils/latency_clock.h"
 #include "utils/utils.h"
 
 namespace ycsbc {
@@ -30,9 +31,21 @@ class DBWrapper : public DB {
   void Cleanup() {
     db_->Cleanup();
   }
+  ///
+  /// Sets the intended start time of the operations issued next by the calling
+  /// thread. Latencies are then measured from this point instead of the actual
+  /// call, so that queueing delay of an open-loop client is included.
+  ///
+  static void SetIntendedStart(utils::ArrivalProcess::Clock::time_point t) {
+    intended_start_ = t;
+    has_intended_start_ = true;
+  }
+  static void ClearIntendedStart() {
+    has_intended_start_ = false;
+  }
   Status Read(const std::string &table, const std::string &key,
               const std::vector<std::string> *fields, std::vector<Field> &result) {
-    timer_.Start();
+    StartTimer();
     Status s = db_->Read(table, key, fields, result);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
@@ -44,7 +57,7 @@ class DBWrapper : public DB {
   }
   Status Scan(const std::string &table, const std::string &key, int record_count,
               const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
-    timer_.Start();
+    StartTimer();
     Status s = db_->Scan(table, key, record_count, fields, result);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
@@ -55,7 +68,7 @@ class DBWrapper : public DB {
     return s;
   }
   Status Update(const std::string &table, const std::string &key, std::vector<Field> &values) {
-    timer_.Start();
+    StartTimer();
     Status s = db_->Update(table, key, values);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
@@ -66,7 +79,7 @@ class DBWrapper : public DB {
     return s;
   }
   Status Insert(const std::string &table, const std::string &key, std::vector<Field> &values) {
-    timer_.Start();
+    StartTimer();
     Status s = db_->Insert(table, key, values);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
@@ -77,7 +90,7 @@ class DBWrapper : public DB {
     return s;
   }
   Status Delete(const std::string &table, const std::string &key) {
-    timer_.Start();
+    StartTimer();
     Status s = db_->Delete(table, key);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
@@ -87,12 +100,109 @@ class DBWrapper : public DB {
     }
     return s;
   }
+  Status BatchRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields,
+                   std::vector<std::vector<Field>> &result) {
+    StartTimer();
+    Status s = db_->BatchRead(table, keys, fields, result);
+    ReportBatch(s, keys.size(), BATCH_READ, BATCH_READ_FAILED);
+    return s;
+  }
+  Status BatchUpdate(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values) {
+    StartTimer();
+    Status s = db_->BatchUpdate(table, keys, values);
+    ReportBatch(s, keys.size(), BATCH_UPDATE, BATCH_UPDATE_FAILED);
+    return s;
+  }
+  Status BatchInsert(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values) {
+    StartTimer();
+    Status s = db_->BatchInsert(table, keys, values);
+    ReportBatch(s, keys.size(), BATCH_INSERT, BATCH_INSERT_FAILED);
+    return s;
+  }
+  Status BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                    std::vector<std::vector<Field>> &values) {
+    StartTimer();
+    Status s = db_->BulkInsert(table, keys, values);
+    ReportBatch(s, keys.size(), BATCH_INSERT, BATCH_INSERT_FAILED);
+    return s;
+  }
+  Status Snapshot(const std::string &dir) {
+    return db_->Snapshot(dir);
+  }
+  Status Restore(const std::string &dir) {
+    return db_->Restore(dir);
+  }
+  void ReadAsync(const std::string &table, const std::string &key,
+                 const std::vector<std::string> *fields, std::vector<Field> &result, Callback cb) {
+    db_->ReadAsync(table, key, fields, result, Completion(READ, READ_FAILED, std::move(cb)));
+  }
+  void ScanAsync(const std::string &table, const std::string &key, int record_count,
+                 const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result,
+                 Callback cb) {
+    db_->ScanAsync(table, key, record_count, fields, result,
+                   Completion(SCAN, SCAN_FAILED, std::move(cb)));
+  }
+  void UpdateAsync(const std::string &table, const std::string &key, std::vector<Field> &values,
+                   Callback cb) {
+    db_->UpdateAsync(table, key, values, Completion(UPDATE, UPDATE_FAILED, std::move(cb)));
+  }
+  void InsertAsync(const std::string &table, const std::string &key, std::vector<Field> &values,
+                   Callback cb) {
+    db_->InsertAsync(table, key, values, Completion(INSERT, INSERT_FAILED, std::move(cb)));
+  }
+  void DeleteAsync(const std::string &table, const std::string &key, Callback cb) {
+    db_->DeleteAsync(table, key, Completion(DELETE, DELETE_FAILED, std::move(cb)));
+  }
+  bool NativeAsync() const {
+    return db_->NativeAsync();
+  }
  private:
+  void StartTimer() {
+    if (has_intended_start_) {
+      timer_.Start(intended_start_);
+    } else {
+      timer_.Start();
+    }
+  }
+
+  // Reports the latency of the whole batch along with its number of keys
+  void ReportBatch(Status s, size_t n, Operation batch_op, Operation batch_failed_op) {
+    uint64_t elapsed = timer_.End();
+    if (n == 0) {
+      return;
+    }
+    measurements_->ReportBatch(s == kOK ? batch_op : batch_failed_op, elapsed, n);
+  }
+
+  // Starts a timer at submission and reports the latency on completion
+  Callback Completion(Operation op, Operation failed_op, Callback cb) {
+    utils::LatencyTimer timer;
+    if (has_intended_start_) {
+      timer.Start(intended_start_);
+    } else {
+      timer.Start();
+    }
+    return [this, timer, op, failed_op, cb](Status s) mutable {
+      uint64_t elapsed = timer.End();
+      measurements_->Report(s == kOK ? op : failed_op, elapsed);
+      cb(s);
+    };
+  }
+
+  static thread_local bool has_intended_start_;
+  static thread_local utils::ArrivalProcess::Clock::time_point intended_start_;
+
   DB *db_;
   Measurements *measurements_;
-  utils::Timer<uint64_t, std::nano> timer_;
+  utils::LatencyTimer timer_;
 };
 
+inline thread_local bool DBWrapper::has_intended_start_ = false;
+inline thread_local utils::ArrivalProcess::Clock::time_point DBWrapper::intended_start_;
+
 } // ycsbc
 
 #endif // YCSB_C_DB_WRAPPER_H_
@@ -0,0 +1,99 @@
+//
+//  deleted_key_tracker.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_DELETED_KEY_TRACKER_H_
+#define YCSB_C_DELETED_KEY_TRACKER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "utils/random.h"
+
+namespace ycsbc {
+
+///
+/// Tracks which key numbers of the transaction phase are deleted, so that
+/// operations can avoid them, read them back deliberately, or reinsert them.
+/// Lookups read one bit without locking; the list of deleted keys that is
+/// sampled from is guarded by a mutex, which only deletes and reinserts take.
+///
+class DeletedKeyTracker {
+ public:
+  ///
+  /// @param capacity Key numbers from 0 up to capacity are tracked.
+  ///
+  explicit DeletedKeyTracker(uint64_t capacity)
+      : capacity_(capacity), bits_(new std::atomic<uint64_t>[capacity / 64 + 1]()) {}
+
+  bool IsDeleted(uint64_t key_num) const {
+    return key_num < capacity_ &&
+           (bits_[key_num / 64].load(std::memory_order_relaxed) & Mask(key_num)) != 0;
+  }
+
+  ///
+  /// Records a key the database has deleted.
+  ///
+  void MarkDeleted(uint64_t key_num) {
+    if (key_num >= capacity_) {
+      return;
+    }
+    if ((bits_[key_num / 64].fetch_or(Mask(key_num), std::memory_order_relaxed) & Mask(key_num)) == 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      deleted_.push_back(key_num);
+    }
+  }
+
+  ///
+  /// Chooses a random deleted key to be reinserted and stops offering it.
+  /// The key counts as deleted until MarkLive() is called once it is
+  /// reinserted. Returns false if no key is deleted.
+  ///
+  bool TakeRandom(uint64_t &key_num) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (deleted_.empty()) {
+      return false;
+    }
+    size_t i = utils::ThreadRandom().Uniform(deleted_.size());
+    key_num = deleted_[i];
+    deleted_[i] = deleted_.back();
+    deleted_.pop_back();
+    return true;
+  }
+
+  ///
+  /// Chooses a random deleted key. Returns false if no key is deleted.
+  ///
+  bool PeekRandom(uint64_t &key_num) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (deleted_.empty()) {
+      return false;
+    }
+    key_num = deleted_[utils::ThreadRandom().Uniform(deleted_.size())];
+    return true;
+  }
+
+  void MarkLive(uint64_t key_num) {
+    if (key_num < capacity_) {
+      bits_[key_num / 64].fetch_and(~Mask(key_num), std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  static uint64_t Mask(uint64_t key_num) {
+    return uint64_t{1} << (key_num % 64);
+  }
+
+  const uint64_t capacity_;
+  std::unique_ptr<std::atomic<uint64_t>[]> bits_;
+  mutable std::mutex mutex_;
+  std::vector<uint64_t> deleted_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_DELETED_KEY_TRACKER_H_
@@ -11,50 +11,119 @@
 
 #include "generator.h"
 
-#include <atomic>
 #include <cassert>
 #include <vector>
-#include "utils/utils.h"
+#include "utils/random.h"
 
 namespace ycsbc {
 
+///
+/// Chooses among weighted values in constant time with Vose's alias method.
+/// Values are added before the first call to Next(), which is then safe to
+/// call from any number of threads without touching shared state.
+///
 template <typename Value>
 class DiscreteGenerator : public Generator<Value> {
  public:
   DiscreteGenerator() : sum_(0) { }
   void AddValue(Value value, double weight);
+  ///
+  /// Adds many values at once, building the table only once.
+  ///
+  void AddValues(const std::vector<std::pair<Value, double>> &values);
 
   Value Next();
-  Value Last() { return last_; }
+  ///
+  /// Returns the value last chosen by the calling thread.
+  ///
+  Value Last();
 
  private:
+  struct Column {
+    double prob; // probability of taking value rather than alias
+    Value value;
+    Value alias;
+  };
+
+  void BuildTable();
+
   std::vector<std::pair<Value, double>> values_;
   double sum_;
-  std::atomic<Value> last_;
+  std::vector<Column> table_;
+
+  struct LastValue {
+    const DiscreteGenerator *owner;
+    Value value;
+  };
+  static inline thread_local LastValue last_ = {nullptr, Value()};
 };
 
 template <typename Value>
 inline void DiscreteGenerator<Value>::AddValue(Value value, double weight) {
-  if (values_.empty()) {
-    last_ = value;
-  }
   values_.push_back(std::make_pair(value, weight));
   sum_ += weight;
+  BuildTable();
 }
 
 template <typename Value>
-inline Value DiscreteGenerator<Value>::Next() {
-  double chooser = utils::ThreadLocalRandomDouble();
+inline void DiscreteGenerator<Value>::AddValues(const std::vector<std::pair<Value, double>> &values) {
+  for (const auto &value : values) {
+    values_.push_back(value);
+    sum_ += value.second;
+  }
+  BuildTable();
+}
 
-  for (auto p = values_.cbegin(); p != values_.cend(); ++p) {
-    if (chooser < p->second / sum_) {
-      return last_ = p->first;
+template <typename Value>
+inline void DiscreteGenerator<Value>::BuildTable() {
+  const size_t n = values_.size();
+  table_.resize(n);
+  std::vector<double> scaled(n);
+  std::vector<size_t> small, large;
+  for (size_t i = 0; i < n; i++) {
+    scaled[i] = values_[i].second * n / sum_;
+    (scaled[i] < 1.0 ? small : large).push_back(i);
+  }
+  // pair each underfull column with an overfull one that tops it up
+  while (!small.empty() && !large.empty()) {
+    size_t s = small.back();
+    size_t l = large.back();
+    small.pop_back();
+    table_[s] = {scaled[s], values_[s].first, values_[l].first};
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
     }
-    chooser -= p->second / sum_;
   }
+  // the rest are full up to rounding
+  for (size_t i : large) {
+    table_[i] = {1.0, values_[i].first, values_[i].first};
+  }
+  for (size_t i : small) {
+    table_[i] = {1.0, values_[i].first, values_[i].first};
+  }
+}
 
-  assert(false);
-  return last_;
+template <typename Value>
+inline Value DiscreteGenerator<Value>::Next() {
+  assert(!table_.empty());
+  Value value;
+  if (table_.size() == 1) {
+    value = table_[0].value;
+  } else {
+    utils::Random &rng = utils::ThreadRandom();
+    const Column &column = table_[rng.Uniform(table_.size())];
+    value = rng.NextDouble() < column.prob ? column.value : column.alias;
+  }
+  last_ = {this, value};
+  return value;
+}
+
+template <typename Value>
+inline Value DiscreteGenerator<Value>::Last() {
+  assert(!values_.empty());
+  return last_.owner == this ? last_.value : values_.front().first;
 }
 
 } // ycsbc
@@ -0,0 +1,157 @@
+//
+//  executor_db.cc
+//  YCSB-cpp
+//
+
+#include "executor_db.h"
+
+#include <cstdlib>
+#include <future>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+ExecutorDB::~ExecutorDB() {
+  for (DB *db : dbs_) {
+    delete db;
+  }
+}
+
+void ExecutorDB::Init() {
+  for (DB *db : dbs_) {
+    db->Init();
+  }
+  stop_ = false;
+  for (DB *db : dbs_) {
+    workers_.emplace_back(&ExecutorDB::WorkerLoop, this, db);
+  }
+}
+
+void ExecutorDB::Cleanup() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (std::thread &t : workers_) {
+    t.join();
+  }
+  workers_.clear();
+  for (DB *db : dbs_) {
+    db->Cleanup();
+  }
+}
+
+void ExecutorDB::WorkerLoop(DB *db) {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    try {
+      task(db);
+    } catch (const utils::Exception &e) {
+      std::cerr << "Caught exception: " << e.what() << std::endl;
+      exit(1);
+    }
+  }
+}
+
+void ExecutorDB::Submit(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+DB::Status ExecutorDB::Wait(std::function<Status(DB *)> op) {
+  std::promise<Status> promise;
+  std::future<Status> future = promise.get_future();
+  Submit([&](DB *db) { promise.set_value(op(db)); });
+  return future.get();
+}
+
+DB::Status ExecutorDB::Read(const std::string &table, const std::string &key,
+                            const std::vector<std::string> *fields, std::vector<Field> &result) {
+  return Wait([&](DB *db) { return db->Read(table, key, fields, result); });
+}
+
+DB::Status ExecutorDB::Scan(const std::string &table, const std::string &key, int record_count,
+                            const std::vector<std::string> *fields,
+                            std::vector<std::vector<Field>> &result) {
+  return Wait([&](DB *db) { return db->Scan(table, key, record_count, fields, result); });
+}
+
+DB::Status ExecutorDB::Update(const std::string &table, const std::string &key,
+                              std::vector<Field> &values) {
+  return Wait([&](DB *db) { return db->Update(table, key, values); });
+}
+
+DB::Status ExecutorDB::Insert(const std::string &table, const std::string &key,
+                              std::vector<Field> &values) {
+  return Wait([&](DB *db) { return db->Insert(table, key, values); });
+}
+
+DB::Status ExecutorDB::Delete(const std::string &table, const std::string &key) {
+  return Wait([&](DB *db) { return db->Delete(table, key); });
+}
+
+DB::Status ExecutorDB::BatchRead(const std::string &table, const std::vector<std::string> &keys,
+                                 const std::vector<std::string> *fields,
+                                 std::vector<std::vector<Field>> &result) {
+  return Wait([&](DB *db) { return db->BatchRead(table, keys, fields, result); });
+}
+
+DB::Status ExecutorDB::BatchUpdate(const std::string &table, const std::vector<std::string> &keys,
+                                   std::vector<std::vector<Field>> &values) {
+  return Wait([&](DB *db) { return db->BatchUpdate(table, keys, values); });
+}
+
+DB::Status ExecutorDB::BatchInsert(const std::string &table, const std::vector<std::string> &keys,
+                                   std::vector<std::vector<Field>> &values) {
+  return Wait([&](DB *db) { return db->BatchInsert(table, keys, values); });
+}
+
+DB::Status ExecutorDB::BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                                  std::vector<std::vector<Field>> &values) {
+  return Wait([&](DB *db) { return db->BulkInsert(table, keys, values); });
+}
+
+void ExecutorDB::ReadAsync(const std::string &table, const std::string &key,
+                           const std::vector<std::string> *fields, std::vector<Field> &result,
+                           Callback cb) {
+  Submit([&table, &key, fields, &result, cb](DB *db) { cb(db->Read(table, key, fields, result)); });
+}
+
+void ExecutorDB::ScanAsync(const std::string &table, const std::string &key, int record_count,
+                           const std::vector<std::string> *fields,
+                           std::vector<std::vector<Field>> &result, Callback cb) {
+  Submit([&table, &key, record_count, fields, &result, cb](DB *db) {
+    cb(db->Scan(table, key, record_count, fields, result));
+  });
+}
+
+void ExecutorDB::UpdateAsync(const std::string &table, const std::string &key,
+                             std::vector<Field> &values, Callback cb) {
+  Submit([&table, &key, &values, cb](DB *db) { cb(db->Update(table, key, values)); });
+}
+
+void ExecutorDB::InsertAsync(const std::string &table, const std::string &key,
+                             std::vector<Field> &values, Callback cb) {
+  Submit([&table, &key, &values, cb](DB *db) { cb(db->Insert(table, key, values)); });
+}
+
+void ExecutorDB::DeleteAsync(const std::string &table, const std::string &key, Callback cb) {
+  Submit([&table, &key, cb](DB *db) { cb(db->Delete(table, key)); });
+}
+
+} // ycsbc
@@ -0,0 +1,83 @@
+//
+//  executor_db.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_EXECUTOR_DB_H_
+#define YCSB_C_EXECUTOR_DB_H_
+
+#include "db.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ycsbc {
+
+///
+/// Runs the operations of bindings without native async support on a small
+/// pool of worker threads. Each worker owns one DB instance.
+///
+class ExecutorDB : public DB {
+ public:
+  ExecutorDB(const std::vector<DB *> &dbs) : dbs_(dbs), stop_(false) {}
+  ~ExecutorDB();
+
+  void Init();
+  void Cleanup();
+
+  Status Read(const std::string &table, const std::string &key,
+              const std::vector<std::string> *fields, std::vector<Field> &result);
+  Status Scan(const std::string &table, const std::string &key, int record_count,
+              const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result);
+  Status Update(const std::string &table, const std::string &key, std::vector<Field> &values);
+  Status Insert(const std::string &table, const std::string &key, std::vector<Field> &values);
+  Status Delete(const std::string &table, const std::string &key);
+
+  Status BatchRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields,
+                   std::vector<std::vector<Field>> &result);
+  Status BatchUpdate(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values);
+  Status BatchInsert(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values);
+  Status BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                    std::vector<std::vector<Field>> &values);
+
+  Status Snapshot(const std::string &dir) { return dbs_[0]->Snapshot(dir); }
+  Status Restore(const std::string &dir) { return dbs_[0]->Restore(dir); }
+
+  void ReadAsync(const std::string &table, const std::string &key,
+                 const std::vector<std::string> *fields, std::vector<Field> &result, Callback cb);
+  void ScanAsync(const std::string &table, const std::string &key, int record_count,
+                 const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result,
+                 Callback cb);
+  void UpdateAsync(const std::string &table, const std::string &key, std::vector<Field> &values,
+                   Callback cb);
+  void InsertAsync(const std::string &table, const std::string &key, std::vector<Field> &values,
+                   Callback cb);
+  void DeleteAsync(const std::string &table, const std::string &key, Callback cb);
+
+  bool NativeAsync() const { return true; }
+
+ private:
+  using Task = std::function<void(DB *)>;
+
+  void Submit(Task task);
+  Status Wait(std::function<Status(DB *)> op);
+  void WorkerLoop(DB *db);
+
+  std::vector<DB *> dbs_;
+  std::vector<std::thread> workers_;
+  std::deque<Task> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_EXECUTOR_DB_H_
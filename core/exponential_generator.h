@@ -0,0 +1,45 @@
+//
+//  exponential_generator.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_EXPONENTIAL_GENERATOR_H_
+#define YCSB_C_EXPONENTIAL_GENERATOR_H_
+
+#include "generator.h"
+
+#include <atomic>
+#include <cmath>
+
+#include "utils/random.h"
+
+namespace ycsbc {
+
+///
+/// Chooses exponentially distributed values from zero up, so that the given
+/// percentile of the values falls below range. Larger values are rare but
+/// possible; callers drop those they cannot use.
+///
+class ExponentialGenerator : public Generator<uint64_t> {
+ public:
+  ExponentialGenerator(double percentile, double range)
+      : gamma_(-std::log1p(-percentile / 100.0) / range) {
+    Next();
+  }
+
+  uint64_t Next() {
+    uint64_t value = -std::log1p(-utils::ThreadRandom().NextDouble()) / gamma_;
+    last_.store(value, std::memory_order_relaxed);
+    return value;
+  }
+
+  uint64_t Last() { return last_.load(std::memory_order_relaxed); }
+
+ private:
+  const double gamma_;
+  std::atomic<uint64_t> last_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_EXPONENTIAL_GENERATOR_H_
@@ -0,0 +1,103 @@
+//
+//  histogram_generator.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_HISTOGRAM_GENERATOR_H_
+#define YCSB_C_HISTOGRAM_GENERATOR_H_
+
+#include "generator.h"
+#include "discrete_generator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utils/random.h"
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// Chooses values following a histogram read from a file, in constant time
+/// through an alias table over its buckets. Each line of the file is either
+/// "value weight" for a single value or "min max weight" for a range whose
+/// values are chosen uniformly. Blank lines and lines starting with '#' are
+/// skipped. Weights are relative and need not sum to anything.
+///
+class HistogramGenerator : public Generator<uint64_t> {
+ public:
+  explicit HistogramGenerator(const std::string &path) : max_(0) {
+    std::ifstream input(path);
+    if (!input) {
+      throw utils::Exception("cannot open histogram " + path);
+    }
+    std::vector<std::pair<uint32_t, double>> weights;
+    std::string line;
+    for (int line_num = 1; std::getline(input, line); line_num++) {
+      size_t start = line.find_first_not_of(" \t\r");
+      if (start == std::string::npos || line[start] == '#') {
+        continue;
+      }
+      std::istringstream fields(line);
+      std::vector<double> v;
+      double x;
+      while (fields >> x) {
+        v.push_back(x);
+      }
+      if (!fields.eof() || (v.size() != 2 && v.size() != 3)) {
+        throw utils::Exception("bad histogram line " + std::to_string(line_num) + " in " + path);
+      }
+      Bucket bucket = {static_cast<uint64_t>(v[0]), static_cast<uint64_t>(v[v.size() - 2])};
+      double weight = v.back();
+      if (v[0] < 0 || bucket.max < bucket.min || weight < 0) {
+        throw utils::Exception("bad histogram line " + std::to_string(line_num) + " in " + path);
+      }
+      if (weight == 0) {
+        continue;
+      }
+      weights.emplace_back(buckets_.size(), weight);
+      buckets_.push_back(bucket);
+      max_ = std::max(max_, bucket.max);
+    }
+    if (buckets_.empty()) {
+      throw utils::Exception("empty histogram " + path);
+    }
+    bucket_chooser_.AddValues(weights);
+  }
+
+  uint64_t Next() {
+    const Bucket &bucket = buckets_[bucket_chooser_.Next()];
+    if (bucket.min == bucket.max) {
+      return bucket.min;
+    }
+    return bucket.min + utils::ThreadRandom().Uniform(bucket.max - bucket.min + 1);
+  }
+
+  ///
+  /// Returns the bucket of the value last chosen by the calling thread,
+  /// as its smallest value.
+  ///
+  uint64_t Last() { return buckets_[bucket_chooser_.Last()].min; }
+
+  ///
+  /// Returns the largest value that can be chosen.
+  ///
+  uint64_t max() const { return max_; }
+
+ private:
+  struct Bucket {
+    uint64_t min;
+    uint64_t max;
+  };
+
+  std::vector<Bucket> buckets_;
+  DiscreteGenerator<uint32_t> bucket_chooser_;
+  uint64_t max_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_HISTOGRAM_GENERATOR_H_
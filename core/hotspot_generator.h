@@ -0,0 +1,61 @@
+//
+//  hotspot_generator.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_HOTSPOT_GENERATOR_H_
+#define YCSB_C_HOTSPOT_GENERATOR_H_
+
+#include "generator.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "utils/random.h"
+
+namespace ycsbc {
+
+///
+/// Chooses from a hot set at the start of the range for a fraction of the
+/// calls, and uniformly from the rest of the range otherwise.
+///
+class HotspotGenerator : public Generator<uint64_t> {
+ public:
+  ///
+  /// @param min, max The range, both inclusive.
+  /// @param hot_set_fraction The share of the range that is hot.
+  /// @param hot_op_fraction The share of the calls that choose a hot item.
+  ///
+  HotspotGenerator(uint64_t min, uint64_t max, double hot_set_fraction, double hot_op_fraction)
+      : min_(min), hot_op_fraction_(hot_op_fraction) {
+    uint64_t items = max - min + 1;
+    hot_items_ = std::clamp<uint64_t>(items * hot_set_fraction, 1, items);
+    cold_items_ = items - hot_items_;
+    Next();
+  }
+
+  uint64_t Next() {
+    utils::Random &rng = utils::ThreadRandom();
+    uint64_t value;
+    if (cold_items_ == 0 || rng.NextDouble() < hot_op_fraction_) {
+      value = min_ + rng.Uniform(hot_items_);
+    } else {
+      value = min_ + hot_items_ + rng.Uniform(cold_items_);
+    }
+    last_.store(value, std::memory_order_relaxed);
+    return value;
+  }
+
+  uint64_t Last() { return last_.load(std::memory_order_relaxed); }
+
+ private:
+  const uint64_t min_;
+  const double hot_op_fraction_;
+  uint64_t hot_items_;
+  uint64_t cold_items_;
+  std::atomic<uint64_t> last_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_HOTSPOT_GENERATOR_H_
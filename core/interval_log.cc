@@ -0,0 +1,245 @@
+//
+//  interval_log.cc
+//  YCSB-cpp
+//
+
+#include "interval_log.h"
+#include "utils/utils.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace ycsbc {
+
+const std::string IntervalLog::TIMESERIES_PROPERTY = "status.timeseries";
+const std::string IntervalLog::TIMESERIES_FORMAT_PROPERTY = "status.timeseries.format";
+const std::string IntervalLog::TIMESERIES_FORMAT_DEFAULT = "csv";
+const std::string IntervalLog::HDRLOG_PROPERTY = "status.hdrlog";
+
+namespace {
+
+double Seconds(IntervalLog::Clock::duration d) {
+  return std::chrono::duration<double>(d).count();
+}
+
+// Sum of the keys of all operations, as counted by the status line
+uint64_t TotalCount(const MeasurementStats &stats) {
+  uint64_t total = 0;
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    total += stats[i].keys;
+  }
+  return total;
+}
+
+} // anonymous
+
+IntervalLog *IntervalLog::Create(utils::Properties &props) {
+  std::string timeseries = props.GetProperty(TIMESERIES_PROPERTY, "");
+  std::string format = props.GetProperty(TIMESERIES_FORMAT_PROPERTY, TIMESERIES_FORMAT_DEFAULT);
+  std::string hdrlog = props.GetProperty(HDRLOG_PROPERTY, "");
+  if (format != "csv" && format != "json") {
+    throw utils::Exception("unknown " + TIMESERIES_FORMAT_PROPERTY + ": " + format);
+  }
+#ifndef HDRMEASUREMENT
+  if (hdrlog != "") {
+    throw utils::Exception(HDRLOG_PROPERTY + " requires HdrHistogram support");
+  }
+#endif
+  if (timeseries == "" && hdrlog == "") {
+    return nullptr;
+  }
+  return new IntervalLog(timeseries, format == "json", hdrlog);
+}
+
+IntervalLog::IntervalLog(const std::string &timeseries, bool json, const std::string &hdrlog)
+    : json_(json), hdrlog_(hdrlog) {
+  if (timeseries != "") {
+    timeseries_.open(timeseries);
+    if (!timeseries_) {
+      throw utils::Exception("cannot open " + timeseries);
+    }
+    if (!json_) {
+      timeseries_ << "time,elapsed,phase,operation,count,throughput,avg_us,min_us,max_us";
+      for (double p : kReportedPercentiles) {
+        timeseries_ << ",p" << p << "_us";
+      }
+      timeseries_ << ",total_count,total_avg_us,total_min_us,total_max_us";
+      for (double p : kReportedPercentiles) {
+        timeseries_ << ",total_p" << p << "_us";
+      }
+      timeseries_ << std::endl;
+    }
+  }
+#ifdef HDRMEASUREMENT
+  std::fill(std::begin(hdr_files_), std::end(hdr_files_), nullptr);
+  hdr_log_writer_init(&hdr_writer_);
+#endif
+}
+
+IntervalLog::~IntervalLog() {
+#ifdef HDRMEASUREMENT
+  for (FILE *&f : hdr_files_) {
+    if (f != nullptr) {
+      fclose(f);
+      f = nullptr;
+    }
+  }
+#endif
+}
+
+void IntervalLog::Begin(const std::string &phase, Clock::time_point start) {
+  phase_ = phase;
+  start_ = start;
+  last_ = start;
+#ifdef HDRMEASUREMENT
+  // every phase gets its own set of logs
+  for (FILE *&f : hdr_files_) {
+    if (f != nullptr) {
+      fclose(f);
+      f = nullptr;
+    }
+  }
+#endif
+}
+
+void IntervalLog::Write(Clock::time_point now, const MeasurementStats &interval,
+                        const MeasurementStats &cumulative) {
+  double seconds = Seconds(now - last_);
+  if (timeseries_.is_open()) {
+    double time = Seconds(now.time_since_epoch());
+    double elapsed = Seconds(now - start_);
+    if (json_) {
+      WriteJson(time, elapsed, seconds, interval, cumulative);
+    } else {
+      WriteCsv(time, elapsed, seconds, interval, cumulative);
+    }
+    timeseries_.flush();
+  }
+  if (hdrlog_ != "") {
+    WriteHdrLog(now, interval);
+  }
+  last_ = now;
+}
+
+void IntervalLog::WriteCsv(double time, double elapsed, double seconds,
+                           const MeasurementStats &interval, const MeasurementStats &cumulative) {
+  // avg, min, max and the percentiles; empty where unknown
+  auto write_latencies = [this](const LatencyStats &s) {
+    if (s.count > 0) {
+      timeseries_ << s.avg / 1000.0;
+    }
+    timeseries_ << ",";
+    if (s.count > 0 && s.has_extremes) {
+      timeseries_ << s.min / 1000.0 << "," << s.max / 1000.0;
+    } else {
+      timeseries_ << ",";
+    }
+    for (size_t i = 0; i < std::size(kReportedPercentiles); i++) {
+      timeseries_ << ",";
+      if (s.count > 0 && i < s.percentiles.size()) {
+        timeseries_ << s.percentiles[i].second / 1000.0;
+      }
+    }
+  };
+  const std::string no_latencies(2 + std::size(kReportedPercentiles), ',');
+
+  timeseries_ << std::fixed << std::setprecision(3);
+  uint64_t total = TotalCount(interval);
+  timeseries_ << time << "," << elapsed << "," << phase_ << ",ALL,"
+              << total << "," << (seconds > 0 ? total / seconds : 0) << "," << no_latencies
+              << "," << TotalCount(cumulative) << "," << no_latencies << std::endl;
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    if (cumulative[i].count == 0) {
+      continue;
+    }
+    timeseries_ << time << "," << elapsed << "," << phase_ << "," << kOperationString[i] << ","
+                << interval[i].count << "," << (seconds > 0 ? interval[i].count / seconds : 0) << ",";
+    write_latencies(interval[i]);
+    timeseries_ << "," << cumulative[i].count << ",";
+    write_latencies(cumulative[i]);
+    timeseries_ << std::endl;
+  }
+}
+
+void IntervalLog::WriteJson(double time, double elapsed, double seconds,
+                            const MeasurementStats &interval, const MeasurementStats &cumulative) {
+  auto write_stats = [this](Operation op, const LatencyStats &s) {
+    timeseries_ << "{\"count\": " << s.count;
+    if (IsBatchOperation(op)) {
+      timeseries_ << ", \"keys\": " << s.keys;
+    }
+    if (s.count > 0) {
+      timeseries_ << ", \"avg_us\": " << s.avg / 1000.0;
+      if (s.has_extremes) {
+        timeseries_ << ", \"min_us\": " << s.min / 1000.0 << ", \"max_us\": " << s.max / 1000.0;
+      }
+      if (!s.percentiles.empty()) {
+        timeseries_ << ", \"percentiles_us\": {";
+        for (size_t i = 0; i < s.percentiles.size(); i++) {
+          std::ostringstream label;
+          label << s.percentiles[i].first;
+          timeseries_ << (i > 0 ? ", " : "") << "\"" << label.str() << "\": "
+                      << s.percentiles[i].second / 1000.0;
+        }
+        timeseries_ << "}";
+      }
+    }
+    timeseries_ << "}";
+  };
+
+  timeseries_ << std::fixed << std::setprecision(3);
+  uint64_t total = TotalCount(interval);
+  timeseries_ << "{\"time\": " << time << ", \"elapsed\": " << elapsed
+              << ", \"phase\": \"" << phase_ << "\""
+              << ", \"count\": " << total
+              << ", \"throughput\": " << (seconds > 0 ? total / seconds : 0)
+              << ", \"total_count\": " << TotalCount(cumulative)
+              << ", \"operations\": {";
+  bool first = true;
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    if (cumulative[i].count == 0) {
+      continue;
+    }
+    timeseries_ << (first ? "" : ", ") << "\"" << kOperationString[i] << "\": {\"throughput\": "
+                << (seconds > 0 ? interval[i].count / seconds : 0) << ", \"interval\": ";
+    write_stats(static_cast<Operation>(i), interval[i]);
+    timeseries_ << ", \"total\": ";
+    write_stats(static_cast<Operation>(i), cumulative[i]);
+    timeseries_ << "}";
+    first = false;
+  }
+  timeseries_ << "}}" << std::endl;
+}
+
+void IntervalLog::WriteHdrLog(Clock::time_point now, const MeasurementStats &interval) {
+#ifdef HDRMEASUREMENT
+  auto to_timespec = [](Clock::time_point t) {
+    hdr_timespec ts;
+    hdr_timespec_from_double(&ts, Seconds(t.time_since_epoch()));
+    return ts;
+  };
+  hdr_timespec start = to_timespec(last_);
+  hdr_timespec end = to_timespec(now);
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    hdr_histogram *h = interval[i].histogram;
+    if (h == nullptr) {
+      continue;
+    }
+    if (hdr_files_[i] == nullptr) {
+      std::string path = hdrlog_ + "." + phase_ + "." + kOperationString[i] + ".hlog";
+      hdr_files_[i] = fopen(path.c_str(), "w");
+      if (hdr_files_[i] == nullptr) {
+        throw utils::Exception("cannot open " + path);
+      }
+      hdr_timespec phase_start = to_timespec(start_);
+      hdr_log_write_header(&hdr_writer_, hdr_files_[i], "YCSB-cpp", &phase_start);
+    }
+    if (hdr_log_write(&hdr_writer_, hdr_files_[i], &start, &end, h) != 0) {
+      throw utils::Exception(std::string("hdr log write failed for ") + kOperationString[i]);
+    }
+    fflush(hdr_files_[i]);
+  }
+#endif
+}
+
+} // ycsbc
@@ -0,0 +1,75 @@
+//
+//  interval_log.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_INTERVAL_LOG_H_
+#define YCSB_C_INTERVAL_LOG_H_
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "measurements.h"
+#include "utils/properties.h"
+
+#ifdef HDRMEASUREMENT
+#include <hdr/hdr_histogram_log.h>
+#endif
+
+namespace ycsbc {
+
+///
+/// Writes the statistics of every status interval to a CSV or JSON lines time
+/// series, and the interval histograms to HdrHistogram interval logs, one file
+/// per phase and operation type.
+///
+class IntervalLog {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  static const std::string TIMESERIES_PROPERTY;
+  static const std::string TIMESERIES_FORMAT_PROPERTY;
+  static const std::string TIMESERIES_FORMAT_DEFAULT;
+  static const std::string HDRLOG_PROPERTY;
+
+  ///
+  /// Returns nullptr if no interval output is configured.
+  ///
+  static IntervalLog *Create(utils::Properties &props);
+  ~IntervalLog();
+
+  ///
+  /// Starts a new phase. Its intervals are labeled with phase.
+  ///
+  void Begin(const std::string &phase, Clock::time_point start);
+  ///
+  /// Writes one interval that ended at now.
+  ///
+  void Write(Clock::time_point now, const MeasurementStats &interval,
+             const MeasurementStats &cumulative);
+
+ private:
+  IntervalLog(const std::string &timeseries, bool json, const std::string &hdrlog);
+  void WriteCsv(double time, double elapsed, double seconds, const MeasurementStats &interval,
+                const MeasurementStats &cumulative);
+  void WriteJson(double time, double elapsed, double seconds, const MeasurementStats &interval,
+                 const MeasurementStats &cumulative);
+  void WriteHdrLog(Clock::time_point now, const MeasurementStats &interval);
+
+  std::ofstream timeseries_;
+  bool json_;
+  std::string hdrlog_;
+  std::string phase_;
+  Clock::time_point start_;
+  Clock::time_point last_;
+#ifdef HDRMEASUREMENT
+  hdr_log_writer hdr_writer_;
+  FILE *hdr_files_[MAXOPTYPE];
+#endif
+};
+
+} // ycsbc
+
+#endif // YCSB_C_INTERVAL_LOG_H_
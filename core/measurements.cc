@@ -23,94 +23,304 @@ namespace {
 
 namespace ycsbc {
 
-BasicMeasurements::BasicMeasurements() : count_{}, latency_sum_{}, latency_max_{} {
-  std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
+std::string Measurements::GetStatusMsg() {
+  MeasurementStats stats;
+  GetStats(stats);
+  return FormatStatus(stats);
 }
 
-void BasicMeasurements::Report(Operation op, uint64_t latency) {
-  count_[op].fetch_add(1, std::memory_order_relaxed);
-  latency_sum_[op].fetch_add(latency, std::memory_order_relaxed);
-  uint64_t prev_min = latency_min_[op].load(std::memory_order_relaxed);
-  while (prev_min > latency
-         && !latency_min_[op].compare_exchange_weak(prev_min, latency, std::memory_order_relaxed));
-  uint64_t prev_max = latency_max_[op].load(std::memory_order_relaxed);
-  while (prev_max < latency
-         && !latency_max_[op].compare_exchange_weak(prev_max, latency, std::memory_order_relaxed));
-}
-
-std::string BasicMeasurements::GetStatusMsg() {
+std::string Measurements::FormatStatus(const MeasurementStats &stats) {
   std::ostringstream msg_stream;
   msg_stream.precision(2);
   uint64_t total_cnt = 0;
   msg_stream << std::fixed << " operations;";
   for (int i = 0; i < MAXOPTYPE; i++) {
     Operation op = static_cast<Operation>(i);
-    uint64_t cnt = count_[op].load(std::memory_order_relaxed);
-    if (cnt == 0)
+    const LatencyStats &s = stats[op];
+    if (s.count == 0)
       continue;
     msg_stream << " [" << kOperationString[op] << ":"
-               << " Count=" << cnt
-               << " Max=" << latency_max_[op].load(std::memory_order_relaxed) / 1000.0
-               << " Min=" << latency_min_[op].load(std::memory_order_relaxed) / 1000.0
-               << " Avg="
-               << ((cnt > 0)
-                   ? static_cast<double>(latency_sum_[op].load(std::memory_order_relaxed)) / cnt
-                   : 0) / 1000.0
-               << "]";
-    total_cnt += cnt;
+               << " Count=" << s.count;
+    if (IsBatchOperation(op)) {
+      msg_stream << " Keys=" << s.keys;
+    }
+    if (s.has_extremes) {
+      msg_stream << " Max=" << s.max / 1000.0
+                 << " Min=" << s.min / 1000.0;
+    }
+    msg_stream << " Avg=" << s.avg / 1000.0;
+    for (const auto &p : s.percentiles) {
+      std::ostringstream label;
+      label << p.first;
+      msg_stream << " " << label.str() << "=" << p.second / 1000.0;
+    }
+    msg_stream << "]";
+    total_cnt += s.keys;
   }
   return std::to_string(total_cnt) + msg_stream.str();
 }
 
+BasicMeasurements::Shard::Shard() {
+  Clear();
+}
+
+void BasicMeasurements::Shard::Clear() {
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    count[op].store(0, std::memory_order_relaxed);
+    latency_sum[op].store(0, std::memory_order_relaxed);
+    latency_min[op].store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    latency_max[op].store(0, std::memory_order_relaxed);
+    keys[op].store(0, std::memory_order_relaxed);
+  }
+}
+
+void BasicMeasurements::Report(Operation op, uint64_t latency) {
+  // only this thread writes its shard, so plain loads and stores suffice
+  Shard *shard = shards_.Local();
+  shard->count[op].store(shard->count[op].load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  shard->latency_sum[op].store(shard->latency_sum[op].load(std::memory_order_relaxed) + latency,
+                               std::memory_order_relaxed);
+  if (latency < shard->latency_min[op].load(std::memory_order_relaxed)) {
+    shard->latency_min[op].store(latency, std::memory_order_relaxed);
+  }
+  if (latency > shard->latency_max[op].load(std::memory_order_relaxed)) {
+    shard->latency_max[op].store(latency, std::memory_order_relaxed);
+  }
+}
+
+void BasicMeasurements::ReportBatch(Operation op, uint64_t latency, uint64_t keys) {
+  Report(op, latency);
+  Shard *shard = shards_.Local();
+  shard->keys[op].store(shard->keys[op].load(std::memory_order_relaxed) + keys,
+                        std::memory_order_relaxed);
+}
+
+void BasicMeasurements::Merge(uint64_t *count, uint64_t *latency_sum, uint64_t *keys,
+                              MeasurementStats &cumulative) {
+  uint64_t latency_min[MAXOPTYPE];
+  uint64_t latency_max[MAXOPTYPE] = {};
+  std::fill(count, count + MAXOPTYPE, 0);
+  std::fill(latency_sum, latency_sum + MAXOPTYPE, 0);
+  std::fill(keys, keys + MAXOPTYPE, 0);
+  std::fill(std::begin(latency_min), std::end(latency_min), std::numeric_limits<uint64_t>::max());
+  shards_.ForEach([&](const Shard &shard) {
+    for (int op = 0; op < MAXOPTYPE; op++) {
+      count[op] += shard.count[op].load(std::memory_order_relaxed);
+      latency_sum[op] += shard.latency_sum[op].load(std::memory_order_relaxed);
+      latency_min[op] = std::min(latency_min[op], shard.latency_min[op].load(std::memory_order_relaxed));
+      latency_max[op] = std::max(latency_max[op], shard.latency_max[op].load(std::memory_order_relaxed));
+      keys[op] += shard.keys[op].load(std::memory_order_relaxed);
+    }
+  });
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    LatencyStats &s = cumulative[op];
+    s = LatencyStats();
+    s.count = count[op];
+    s.keys = IsBatchOperation(static_cast<Operation>(op)) ? keys[op] : count[op];
+    if (s.count > 0) {
+      s.avg = static_cast<double>(latency_sum[op]) / s.count;
+      s.min = latency_min[op];
+      s.max = latency_max[op];
+    }
+  }
+}
+
+void BasicMeasurements::GetStats(MeasurementStats &cumulative) {
+  uint64_t count[MAXOPTYPE];
+  uint64_t latency_sum[MAXOPTYPE];
+  uint64_t keys[MAXOPTYPE];
+  Merge(count, latency_sum, keys, cumulative);
+}
+
+void BasicMeasurements::Tick(MeasurementStats &interval, MeasurementStats &cumulative) {
+  std::lock_guard<std::mutex> lock(tick_mutex_);
+  uint64_t count[MAXOPTYPE];
+  uint64_t latency_sum[MAXOPTYPE];
+  uint64_t keys[MAXOPTYPE];
+  Merge(count, latency_sum, keys, cumulative);
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    LatencyStats &s = interval[op];
+    s = LatencyStats();
+    // the extremes of an interval cannot be derived from the totals
+    s.has_extremes = false;
+    if (count[op] > tick_count_[op]) {
+      s.count = count[op] - tick_count_[op];
+      s.avg = static_cast<double>(latency_sum[op] - tick_latency_sum_[op]) / s.count;
+    }
+    s.keys = IsBatchOperation(static_cast<Operation>(op)) ? keys[op] - tick_keys_[op] : s.count;
+    tick_count_[op] = count[op];
+    tick_latency_sum_[op] = latency_sum[op];
+    tick_keys_[op] = keys[op];
+  }
+}
+
 void BasicMeasurements::Reset() {
-  std::fill(std::begin(count_), std::end(count_), 0);
-  std::fill(std::begin(latency_sum_), std::end(latency_sum_), 0);
-  std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
-  std::fill(std::begin(latency_max_), std::end(latency_max_), 0);
+  std::lock_guard<std::mutex> lock(tick_mutex_);
+  shards_.Reset();
+  std::fill(std::begin(tick_count_), std::end(tick_count_), 0);
+  std::fill(std::begin(tick_latency_sum_), std::end(tick_latency_sum_), 0);
+  std::fill(std::begin(tick_keys_), std::end(tick_keys_), 0);
 }
 
 #ifdef HDRMEASUREMENT
-HdrHistogramMeasurements::HdrHistogramMeasurements() {
+namespace {
+
+hdr_histogram *NewHistogram() {
+  hdr_histogram *histogram;
+  if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &histogram) != 0) {
+    throw utils::Exception("hdr init failed");
+  }
+  return histogram;
+}
+
+void FillStats(hdr_histogram *h, LatencyStats &s) {
+  s = LatencyStats();
+  s.histogram = h;
+  s.count = h->total_count;
+  s.keys = s.count;
+  if (s.count == 0) {
+    return;
+  }
+  s.avg = hdr_mean(h);
+  s.min = hdr_min(h);
+  s.max = hdr_max(h);
+  for (double p : kReportedPercentiles) {
+    s.percentiles.emplace_back(p, hdr_value_at_percentile(h, p));
+  }
+}
+
+} // anonymous
+
+HdrHistogramMeasurements::Shard::Shard() : histogram{}, keys{} {}
+
+HdrHistogramMeasurements::Shard::~Shard() {
   for (int op = 0; op < MAXOPTYPE; op++) {
-    if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &histogram_[op]) != 0) {
-      utils::Exception("hdr init failed");
+    hdr_histogram *h = histogram[op].load(std::memory_order_relaxed);
+    if (h != nullptr) {
+      hdr_close(h);
     }
   }
 }
 
+void HdrHistogramMeasurements::Shard::Clear() {
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    hdr_histogram *h = histogram[op].load(std::memory_order_relaxed);
+    if (h != nullptr) {
+      hdr_reset(h);
+    }
+    keys[op].store(0, std::memory_order_relaxed);
+  }
+}
+
+hdr_histogram *HdrHistogramMeasurements::Shard::Get(Operation op) {
+  hdr_histogram *h = histogram[op].load(std::memory_order_relaxed);
+  if (h == nullptr) {
+    h = NewHistogram();
+    histogram[op].store(h, std::memory_order_release);
+  }
+  return h;
+}
+
+HdrHistogramMeasurements::~HdrHistogramMeasurements() {
+  for (auto *histograms : {&merged_, &tick_, &interval_}) {
+    for (hdr_histogram *h : *histograms) {
+      if (h != nullptr) {
+        hdr_close(h);
+      }
+    }
+  }
+}
+
+// The atomic variants keep concurrent readers consistent; they are uncontended
+// since only the owning thread records into a shard.
 void HdrHistogramMeasurements::Report(Operation op, uint64_t latency) {
-  hdr_record_value_atomic(histogram_[op], latency);
+  hdr_record_value_atomic(shards_.Local()->Get(op), latency);
 }
 
-std::string HdrHistogramMeasurements::GetStatusMsg() {
-  std::ostringstream msg_stream;
-  msg_stream.precision(2);
-  uint64_t total_cnt = 0;
-  msg_stream << std::fixed << " operations;";
-  for (int i = 0; i < MAXOPTYPE; i++) {
-    Operation op = static_cast<Operation>(i);
-    uint64_t cnt = histogram_[op]->total_count;
-    if (cnt == 0)
+void HdrHistogramMeasurements::ReportBatch(Operation op, uint64_t latency, uint64_t keys) {
+  Shard *shard = shards_.Local();
+  hdr_record_value_atomic(shard->Get(op), latency);
+  shard->keys[op].store(shard->keys[op].load(std::memory_order_relaxed) + keys,
+                        std::memory_order_relaxed);
+}
+
+void HdrHistogramMeasurements::Merge(MeasurementStats &cumulative) {
+  for (hdr_histogram *h : merged_) {
+    if (h != nullptr) {
+      hdr_reset(h);
+    }
+  }
+  uint64_t keys[MAXOPTYPE] = {};
+  shards_.ForEach([&](const Shard &shard) {
+    for (int op = 0; op < MAXOPTYPE; op++) {
+      keys[op] += shard.keys[op].load(std::memory_order_relaxed);
+      hdr_histogram *h = shard.histogram[op].load(std::memory_order_acquire);
+      if (h == nullptr || h->total_count == 0) {
+        continue;
+      }
+      if (merged_[op] == nullptr) {
+        merged_[op] = NewHistogram();
+      }
+      hdr_add(merged_[op], h);
+    }
+  });
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    if (merged_[op] == nullptr) {
+      cumulative[op] = LatencyStats();
+    } else {
+      FillStats(merged_[op], cumulative[op]);
+      if (IsBatchOperation(static_cast<Operation>(op))) {
+        cumulative[op].keys = keys[op];
+      }
+    }
+  }
+}
+
+void HdrHistogramMeasurements::GetStats(MeasurementStats &cumulative) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Merge(cumulative);
+}
+
+void HdrHistogramMeasurements::Tick(MeasurementStats &interval, MeasurementStats &cumulative) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Merge(cumulative);
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    hdr_histogram *cur = merged_[op];
+    if (cur == nullptr) {
+      interval[op] = LatencyStats();
       continue;
-    msg_stream << " [" << kOperationString[op] << ":"
-               << " Count=" << cnt
-               << " Max=" << hdr_max(histogram_[op]) / 1000.0
-               << " Min=" << hdr_min(histogram_[op]) / 1000.0
-               << " Avg=" << hdr_mean(histogram_[op]) / 1000.0
-               << " 90=" << hdr_value_at_percentile(histogram_[op], 90) / 1000.0
-               << " 99=" << hdr_value_at_percentile(histogram_[op], 99) / 1000.0
-               << " 99.9=" << hdr_value_at_percentile(histogram_[op], 99.9) / 1000.0
-               << " 99.99=" << hdr_value_at_percentile(histogram_[op], 99.99) / 1000.0
-               << "]";
-    total_cnt += cnt;
+    }
+    if (tick_[op] == nullptr) {
+      tick_[op] = NewHistogram();
+      interval_[op] = NewHistogram();
+    }
+    // all histograms share one layout, so the counts can be diffed directly
+    hdr_histogram *prev = tick_[op];
+    hdr_histogram *diff = interval_[op];
+    for (int32_t i = 0; i < cur->counts_len; i++) {
+      diff->counts[i] = std::max<int64_t>(cur->counts[i] - prev->counts[i], 0);
+      prev->counts[i] = cur->counts[i];
+    }
+    hdr_reset_internal_counters(diff);
+    hdr_reset_internal_counters(prev);
+    FillStats(diff, interval[op]);
+    if (IsBatchOperation(static_cast<Operation>(op))) {
+      interval[op].keys = cumulative[op].keys - tick_keys_[op];
+      tick_keys_[op] = cumulative[op].keys;
+    }
   }
-  return std::to_string(total_cnt) + msg_stream.str();
 }
 
 void HdrHistogramMeasurements::Reset() {
-  for (int op = 0; op < MAXOPTYPE; op++) {
-    hdr_reset(histogram_[op]);
+  std::lock_guard<std::mutex> lock(mutex_);
+  shards_.Reset();
+  for (hdr_histogram *h : tick_) {
+    if (h != nullptr) {
+      hdr_reset(h);
+    }
   }
+  std::fill(std::begin(tick_keys_), std::end(tick_keys_), 0);
 }
 #endif
 
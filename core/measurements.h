@@ -10,8 +10,13 @@
 
 #include "core_workload.h"
 #include "utils/properties.h"
+#include "utils/shard_registry.h"
 
+#include <array>
 #include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 #ifdef HDRMEASUREMENT
 #include <hdr/hdr_histogram.h>
@@ -21,35 +26,131 @@ typedef unsigned int uint;
 
 namespace ycsbc {
 
+///
+/// Latency statistics of one operation type, in nanoseconds.
+///
+struct LatencyStats {
+  uint64_t count = 0;
+  ///
+  /// Keys the operations covered; count, except for batch operations.
+  ///
+  uint64_t keys = 0;
+  double avg = 0;
+  ///
+  /// False if min and max are unknown, as for the intervals of basic measurements.
+  ///
+  bool has_extremes = true;
+  uint64_t min = 0;
+  uint64_t max = 0;
+  ///
+  /// Pairs of percentile and latency. Empty if the measurement type keeps no histogram.
+  ///
+  std::vector<std::pair<double, uint64_t>> percentiles;
+#ifdef HDRMEASUREMENT
+  ///
+  /// The histogram behind these statistics, owned by the measurements and
+  /// valid until their next call, or nullptr.
+  ///
+  hdr_histogram *histogram = nullptr;
+#endif
+};
+
+using MeasurementStats = std::array<LatencyStats, MAXOPTYPE>;
+
+///
+/// Percentiles reported by the measurement types that keep a histogram.
+///
+inline constexpr double kReportedPercentiles[] = {50, 90, 99, 99.9, 99.99};
+
 class Measurements {
  public:
   virtual void Report(Operation op, uint64_t latency) = 0;
-  virtual std::string GetStatusMsg() = 0;
+  ///
+  /// Reports one batch operation covering keys keys.
+  ///
+  virtual void ReportBatch(Operation op, uint64_t latency, uint64_t keys) = 0;
+  ///
+  /// Collects the statistics since the last Reset().
+  ///
+  virtual void GetStats(MeasurementStats &cumulative) = 0;
+  ///
+  /// Collects the statistics since the previous call of Tick() (or the last
+  /// Reset()), and those since the last Reset(). Meant to be called by one
+  /// thread at a fixed interval.
+  ///
+  virtual void Tick(MeasurementStats &interval, MeasurementStats &cumulative) = 0;
   virtual void Reset() = 0;
+
+  std::string GetStatusMsg();
+  static std::string FormatStatus(const MeasurementStats &stats);
 };
 
+///
+/// Each reporting thread records into its own shard, which only it writes.
+/// The shards are merged when the statistics are read.
+///
 class BasicMeasurements : public Measurements {
  public:
-  BasicMeasurements();
   void Report(Operation op, uint64_t latency) override;
-  std::string GetStatusMsg() override;
+  void ReportBatch(Operation op, uint64_t latency, uint64_t keys) override;
+  void GetStats(MeasurementStats &cumulative) override;
+  void Tick(MeasurementStats &interval, MeasurementStats &cumulative) override;
   void Reset() override;
  private:
-  std::atomic<uint> count_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_sum_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_min_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_max_[MAXOPTYPE];
+  struct Shard {
+    Shard();
+    void Clear();
+    std::atomic<uint64_t> count[MAXOPTYPE];
+    std::atomic<uint64_t> latency_sum[MAXOPTYPE];
+    std::atomic<uint64_t> latency_min[MAXOPTYPE];
+    std::atomic<uint64_t> latency_max[MAXOPTYPE];
+    std::atomic<uint64_t> keys[MAXOPTYPE];
+  };
+  void Merge(uint64_t *count, uint64_t *latency_sum, uint64_t *keys, MeasurementStats &cumulative);
+
+  utils::ShardRegistry<Shard> shards_;
+  // totals at the previous tick
+  std::mutex tick_mutex_;
+  uint64_t tick_count_[MAXOPTYPE] = {};
+  uint64_t tick_latency_sum_[MAXOPTYPE] = {};
+  uint64_t tick_keys_[MAXOPTYPE] = {};
 };
 
 #ifdef HDRMEASUREMENT
+///
+/// Each reporting thread records into its own histograms, allocated on first
+/// use of an operation type. The histograms are merged when the statistics
+/// are read.
+///
 class HdrHistogramMeasurements : public Measurements {
  public:
-  HdrHistogramMeasurements();
+  ~HdrHistogramMeasurements();
   void Report(Operation op, uint64_t latency) override;
-  std::string GetStatusMsg() override;
+  void ReportBatch(Operation op, uint64_t latency, uint64_t keys) override;
+  void GetStats(MeasurementStats &cumulative) override;
+  void Tick(MeasurementStats &interval, MeasurementStats &cumulative) override;
   void Reset() override;
  private:
-  hdr_histogram *histogram_[MAXOPTYPE];
+  struct Shard {
+    Shard();
+    ~Shard();
+    void Clear();
+    hdr_histogram *Get(Operation op);
+    std::atomic<hdr_histogram *> histogram[MAXOPTYPE];
+    // keys of the batch operations
+    std::atomic<uint64_t> keys[MAXOPTYPE];
+  };
+  // Merges the shards into merged_, and fills cumulative from it
+  void Merge(MeasurementStats &cumulative);
+
+  utils::ShardRegistry<Shard> shards_;
+  // readers' histograms: the merged totals, the totals at the previous tick
+  // and the difference between them
+  std::mutex mutex_;
+  std::array<hdr_histogram *, MAXOPTYPE> merged_ = {};
+  std::array<hdr_histogram *, MAXOPTYPE> tick_ = {};
+  std::array<hdr_histogram *, MAXOPTYPE> interval_ = {};
+  uint64_t tick_keys_[MAXOPTYPE] = {};
 };
 #endif
 
@@ -0,0 +1,60 @@
+//
+//  moving_zipfian_generator.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_MOVING_ZIPFIAN_GENERATOR_H_
+#define YCSB_C_MOVING_ZIPFIAN_GENERATOR_H_
+
+#include "generator.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "zipfian_generator.h"
+
+namespace ycsbc {
+
+///
+/// Zipfian whose hot set drifts through the range over time. The items are
+/// not scrambled, so the popular ones form a contiguous window, which moves
+/// rate positions per second and wraps around at the end. The drift starts
+/// with the first item drawn, not when the generator is created.
+///
+class MovingZipfianGenerator : public Generator<uint64_t> {
+ public:
+  MovingZipfianGenerator(uint64_t min, uint64_t max, double zipfian_const, double rate)
+      : base_(min), num_items_(max - min + 1), rate_(rate), generator_(0, max - min, zipfian_const),
+        start_(0), last_(min) {}
+
+  uint64_t Next() {
+    int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+    int64_t start = start_.load(std::memory_order_relaxed);
+    // the first caller starts the clock; the others load its start time
+    if (start == 0 && start_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+      start = now;
+    }
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::duration(now - start)).count();
+    uint64_t offset = static_cast<uint64_t>(elapsed * rate_) % num_items_;
+    uint64_t value = base_ + (generator_.Next() + offset) % num_items_;
+    last_.store(value, std::memory_order_relaxed);
+    return value;
+  }
+
+  uint64_t Last() { return last_.load(std::memory_order_relaxed); }
+
+ private:
+  const uint64_t base_;
+  const uint64_t num_items_;
+  const double rate_;
+  ZipfianGenerator generator_;
+  // steady clock time of the first item, 0 until then
+  std::atomic<int64_t> start_;
+  std::atomic<uint64_t> last_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_MOVING_ZIPFIAN_GENERATOR_H_
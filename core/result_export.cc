@@ -0,0 +1,234 @@
+//
+//  result_export.cc
+//  YCSB-cpp
+//
+
+#include "result_export.h"
+#include "db_factory.h"
+#include "utils/latency_clock.h"
+#include "utils/utils.h"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+#ifndef YCSB_GIT_REVISION
+#define YCSB_GIT_REVISION "unknown"
+#endif
+
+namespace ycsbc {
+
+const std::string ResultExporter::EXPORT_FILE_PROPERTY = "exportfile";
+
+namespace {
+
+std::string UtcNow() {
+  std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::tm tm;
+#ifdef _WIN32
+  gmtime_s(&tm, &now);
+#else
+  gmtime_r(&now, &tm);
+#endif
+  std::ostringstream out;
+  out << std::put_time(&tm, "%FT%TZ");
+  return out.str();
+}
+
+struct HostInfo {
+  std::string hostname;
+  std::string os;
+  std::string machine;
+};
+
+HostInfo GetHostInfo() {
+  HostInfo info;
+#ifdef _WIN32
+  char name[MAX_COMPUTERNAME_LENGTH + 1] = "";
+  DWORD size = sizeof(name);
+  if (GetComputerNameA(name, &size)) {
+    info.hostname = name;
+  }
+  info.os = "Windows";
+  SYSTEM_INFO system;
+  GetNativeSystemInfo(&system);
+  switch (system.wProcessorArchitecture) {
+    case PROCESSOR_ARCHITECTURE_AMD64:
+      info.machine = "x86_64";
+      break;
+    case PROCESSOR_ARCHITECTURE_ARM64:
+      info.machine = "arm64";
+      break;
+    case PROCESSOR_ARCHITECTURE_INTEL:
+      info.machine = "x86";
+      break;
+    default:
+      info.machine = "unknown";
+  }
+#else
+  char hostname[256] = "";
+  gethostname(hostname, sizeof(hostname) - 1);
+  info.hostname = hostname;
+  struct utsname uts = {};
+  uname(&uts);
+  info.os = std::string(uts.sysname) + " " + uts.release;
+  info.machine = uts.machine;
+#endif
+  return info;
+}
+
+// Latencies are written in microseconds, as in the status line
+void WriteLatencies(std::ostream &out, Operation op, const LatencyStats &s) {
+  out << "{\"count\": " << s.count;
+  if (IsBatchOperation(op)) {
+    out << ", \"keys\": " << s.keys;
+  }
+  if (s.count > 0) {
+    out << ", \"avg_us\": " << s.avg / 1000.0;
+    if (s.has_extremes) {
+      out << ", \"min_us\": " << s.min / 1000.0 << ", \"max_us\": " << s.max / 1000.0;
+    }
+    for (const auto &p : s.percentiles) {
+      std::ostringstream label;
+      label << p.first;
+      out << ", \"p" << label.str() << "_us\": " << p.second / 1000.0;
+    }
+  }
+  out << "}";
+}
+
+} // anonymous
+
+ResultExporter *ResultExporter::Create(const utils::Properties &props, int argc, const char *argv[]) {
+  std::string path = props.GetProperty(EXPORT_FILE_PROPERTY, "");
+  if (path == "") {
+    return nullptr;
+  }
+  std::string command;
+  for (int i = 0; i < argc; i++) {
+    command += (i > 0 ? " " : "") + std::string(argv[i]);
+  }
+  return new ResultExporter(props, path, command);
+}
+
+ResultExporter::ResultExporter(const utils::Properties &props, const std::string &path,
+                               const std::string &command)
+    : props_(props), path_(path), command_(command), start_time_(UtcNow()) {}
+
+void ResultExporter::AddPhase(const std::string &name, double runtime) {
+  phases_.push_back({name, runtime, false, 0, {}});
+}
+
+void ResultExporter::AddPhase(const std::string &name, double runtime, uint64_t operations,
+                              const MeasurementStats &stats) {
+  phases_.push_back({name, runtime, true, operations, stats});
+}
+
+void ResultExporter::Write() {
+  std::ofstream out(path_);
+  if (!out) {
+    throw utils::Exception("cannot open " + path_);
+  }
+  out << std::fixed << std::setprecision(6);
+
+  HostInfo host = GetHostInfo();
+
+  out << "{\n";
+  out << "  \"command\": " << utils::JsonQuote(command_) << ",\n";
+  out << "  \"start_time\": " << utils::JsonQuote(start_time_) << ",\n";
+  out << "  \"end_time\": " << utils::JsonQuote(UtcNow()) << ",\n";
+
+  out << "  \"host\": {\"hostname\": " << utils::JsonQuote(host.hostname)
+      << ", \"os\": " << utils::JsonQuote(host.os)
+      << ", \"machine\": " << utils::JsonQuote(host.machine)
+      << ", \"cpus\": " << std::thread::hardware_concurrency() << "},\n";
+
+  out << "  \"build\": {\"revision\": " << utils::JsonQuote(YCSB_GIT_REVISION)
+#ifdef __VERSION__
+      << ", \"compiler\": " << utils::JsonQuote(__VERSION__)
+#endif
+#ifdef NDEBUG
+      << ", \"debug\": false"
+#else
+      << ", \"debug\": true"
+#endif
+#ifdef HDRMEASUREMENT
+      << ", \"hdrhistogram\": true"
+#else
+      << ", \"hdrhistogram\": false"
+#endif
+      << ", \"bindings\": [";
+  std::vector<std::string> dbs = DBFactory::RegisteredDBs();
+  for (size_t i = 0; i < dbs.size(); i++) {
+    out << (i > 0 ? ", " : "") << utils::JsonQuote(dbs[i]);
+  }
+  out << "]},\n";
+
+  out << "  \"latency_clock\": {\"type\": " << utils::JsonQuote(utils::LatencyClock::Name())
+      << ", \"overhead_ns\": " << utils::LatencyClock::Overhead()
+      << ", \"subtracted_ns\": " << utils::LatencyClock::Correction() << "},\n";
+
+  out << "  \"properties\": {";
+  bool first = true;
+  for (const auto &prop : props_.properties()) {
+    out << (first ? "\n" : ",\n") << "    " << utils::JsonQuote(prop.first) << ": "
+        << utils::JsonQuote(prop.second);
+    first = false;
+  }
+  out << "\n  },\n";
+
+  out << "  \"phases\": [";
+  for (size_t i = 0; i < phases_.size(); i++) {
+    const Phase &phase = phases_[i];
+    out << (i > 0 ? ",\n" : "\n") << "    {\"name\": " << utils::JsonQuote(phase.name)
+        << ", \"runtime_sec\": " << phase.runtime;
+    if (phase.has_operations) {
+      uint64_t failed = 0;
+      out << ", \"operations\": " << phase.operations
+          << ", \"throughput\": " << (phase.runtime > 0 ? phase.operations / phase.runtime : 0)
+          << ",\n     \"latency\": {";
+      first = true;
+      for (int op = 0; op < MAXOPTYPE; op++) {
+        const LatencyStats &s = phase.stats[op];
+        if (s.count == 0) {
+          continue;
+        }
+        if (op >= INSERT_FAILED) {
+          failed += s.keys;
+        }
+        out << (first ? "\n" : ",\n") << "       " << utils::JsonQuote(kOperationString[op]) << ": ";
+        WriteLatencies(out, static_cast<Operation>(op), s);
+        first = false;
+      }
+      out << "},\n     \"failures\": {";
+      first = true;
+      for (int op = INSERT_FAILED; op < MAXOPTYPE; op++) {
+        // failed operations are listed under the name of the operation
+        Operation base = static_cast<Operation>(op - INSERT_FAILED);
+        out << (first ? "" : ", ") << utils::JsonQuote(kOperationString[base]) << ": "
+            << phase.stats[op].count;
+        first = false;
+      }
+      out << "}, \"failed_operations\": " << failed;
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+  if (!out) {
+    throw utils::Exception("cannot write " + path_);
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,64 @@
+//
+//  result_export.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_RESULT_EXPORT_H_
+#define YCSB_C_RESULT_EXPORT_H_
+
+#include <string>
+#include <vector>
+
+#include "measurements.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Collects the results of all phases and writes them as one JSON document,
+/// together with the properties in effect and the host and build details.
+///
+class ResultExporter {
+ public:
+  static const std::string EXPORT_FILE_PROPERTY;
+
+  ///
+  /// Returns nullptr if no export file is configured.
+  ///
+  static ResultExporter *Create(const utils::Properties &props, int argc, const char *argv[]);
+
+  ///
+  /// Adds a phase that only has a runtime, such as restoring a snapshot.
+  ///
+  void AddPhase(const std::string &name, double runtime);
+  ///
+  /// Adds a phase with its operation count and the measurements taken during it.
+  ///
+  void AddPhase(const std::string &name, double runtime, uint64_t operations,
+                const MeasurementStats &stats);
+  ///
+  /// Writes the document. Called once, after the last phase.
+  ///
+  void Write();
+
+ private:
+  struct Phase {
+    std::string name;
+    double runtime;
+    bool has_operations;
+    uint64_t operations;
+    MeasurementStats stats;
+  };
+
+  ResultExporter(const utils::Properties &props, const std::string &path, const std::string &command);
+
+  const utils::Properties &props_;
+  std::string path_;
+  std::string command_;
+  std::string start_time_;
+  std::vector<Phase> phases_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_RESULT_EXPORT_H_
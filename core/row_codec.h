@@ -0,0 +1,240 @@
+//
+//  row_codec.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_ROW_CODEC_H_
+#define YCSB_C_ROW_CODEC_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "db.h"
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// The encoding of a record's fields as one value, shared by the key-value
+/// bindings. An offset header in front of the fields lets a reader reach any
+/// field directly, so reading one field neither parses nor copies the others.
+/// Integers are 32-bit little-endian.
+///
+///   number of fields n
+///   n + 1 offsets of the field entries in the body, the last one its end
+///   body, one entry per field: name length, name, value
+///
+class RowReader {
+ public:
+  ///
+  /// Reads the row in data, which must outlive the reader. Throws if the
+  /// header does not fit in data; each entry is checked when it is read.
+  ///
+  RowReader(const char *data, size_t size) {
+    if (size < sizeof(uint32_t)) {
+      throw utils::Exception("corrupt row");
+    }
+    count_ = Get32(data);
+    size_t header = (count_ + 2) * sizeof(uint32_t);
+    if (count_ > size / sizeof(uint32_t) || header > size) {
+      throw utils::Exception("corrupt row");
+    }
+    offsets_ = data + sizeof(uint32_t);
+    body_ = data + header;
+    if (Offset(count_) != size - header) {
+      throw utils::Exception("corrupt row");
+    }
+  }
+  explicit RowReader(std::string_view data) : RowReader(data.data(), data.size()) {}
+
+  size_t size() const { return count_; }
+
+  std::string_view name(size_t i) const {
+    size_t size;
+    const char *entry = Entry(i, size);
+    return std::string_view(entry + sizeof(uint32_t), Get32(entry));
+  }
+
+  std::string_view value(size_t i) const {
+    size_t size;
+    const char *entry = Entry(i, size);
+    size_t start = sizeof(uint32_t) + Get32(entry);
+    return std::string_view(entry + start, size - start);
+  }
+
+  ///
+  /// Returns the index of the field called name, or -1 if there is none.
+  /// Fields written in the order of the numbers ending their names, as the
+  /// workload writes them, are found without a search.
+  ///
+  int Find(std::string_view name) const {
+    size_t hint = 0;
+    size_t digits = name.size();
+    while (digits > 0 && name[digits - 1] >= '0' && name[digits - 1] <= '9') {
+      digits--;
+    }
+    for (size_t i = digits; i < name.size() && hint < count_; i++) {
+      hint = hint * 10 + (name[i] - '0');
+    }
+    if (hint < count_ && this->name(hint) == name) {
+      return static_cast<int>(hint);
+    }
+    for (size_t i = 0; i < count_; i++) {
+      if (this->name(i) == name) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  ///
+  /// Appends all fields to values.
+  ///
+  void Decode(std::vector<DB::Field> &values) const {
+    for (size_t i = 0; i < count_; i++) {
+      values.push_back({std::string(name(i)), std::string(value(i))});
+    }
+  }
+
+  ///
+  /// Appends the given fields to values, in the order asked for. Fields the
+  /// row does not have are left out.
+  ///
+  void Decode(const std::vector<std::string> &fields, std::vector<DB::Field> &values) const {
+    for (const std::string &field : fields) {
+      int i = Find(field);
+      if (i >= 0) {
+        values.push_back({field, std::string(value(i))});
+      }
+    }
+  }
+
+ private:
+  static uint32_t Get32(const char *p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  size_t Offset(size_t i) const { return Get32(offsets_ + i * sizeof(uint32_t)); }
+
+  ///
+  /// Returns entry i and sets size to its length. Throws unless the entry
+  /// lies within the body and holds its name.
+  ///
+  const char *Entry(size_t i, size_t &size) const {
+    size_t start = Offset(i);
+    size_t end = Offset(i + 1);
+    if (start > end || end > Offset(count_) || end - start < sizeof(uint32_t) ||
+        Get32(body_ + start) > end - start - sizeof(uint32_t)) {
+      throw utils::Exception("corrupt row");
+    }
+    size = end - start;
+    return body_ + start;
+  }
+
+  size_t count_;
+  const char *offsets_;
+  const char *body_;
+};
+
+namespace row_codec_internal {
+
+inline void Put32(std::string &out, size_t pos, uint32_t v) {
+  std::memcpy(&out[pos], &v, sizeof(v));
+}
+
+///
+/// Appends a row of count fields, taking the name and value of each from
+/// field(i), which returns a pair of string_views.
+///
+template <typename FieldAt>
+inline void EncodeRow(size_t count, FieldAt field, std::string &out) {
+  size_t header = out.size();
+  size_t body = header + (count + 2) * sizeof(uint32_t);
+  size_t size = 0;
+  for (size_t i = 0; i < count; i++) {
+    auto f = field(i);
+    size += sizeof(uint32_t) + f.first.size() + f.second.size();
+  }
+  out.resize(body);
+  out.reserve(body + size);
+  Put32(out, header, count);
+  for (size_t i = 0; i < count; i++) {
+    auto f = field(i);
+    Put32(out, header + (i + 1) * sizeof(uint32_t), out.size() - body);
+    uint32_t len = f.first.size();
+    out.append(reinterpret_cast<const char *>(&len), sizeof(len));
+    out.append(f.first.data(), f.first.size());
+    out.append(f.second.data(), f.second.size());
+  }
+  Put32(out, header + (count + 1) * sizeof(uint32_t), out.size() - body);
+}
+
+} // row_codec_internal
+
+///
+/// Appends the row of values to out.
+///
+inline void EncodeRow(const std::vector<DB::Field> &values, std::string &out) {
+  row_codec_internal::EncodeRow(values.size(), [&values](size_t i) {
+    return std::make_pair(std::string_view(values[i].name), std::string_view(values[i].value));
+  }, out);
+}
+
+namespace row_codec_internal {
+
+template <typename NameAt, typename ValueAt>
+inline void UpdateRow(const RowReader &row, size_t count, NameAt name, ValueAt value,
+                      std::string &out) {
+  // update replacing each field of the row, or -1; then the added ones
+  std::vector<int> source(row.size(), -1);
+  std::vector<int> added;
+  for (size_t j = 0; j < count; j++) {
+    int i = row.Find(name(j));
+    if (i >= 0) {
+      source[i] = j;
+    } else {
+      added.push_back(j);
+    }
+  }
+  EncodeRow(row.size() + added.size(), [&](size_t i) {
+    if (i >= row.size()) {
+      int j = added[i - row.size()];
+      return std::make_pair(std::string_view(name(j)), std::string_view(value(j)));
+    } else if (source[i] >= 0) {
+      return std::make_pair(row.name(i), std::string_view(value(source[i])));
+    }
+    return std::make_pair(row.name(i), row.value(i));
+  }, out);
+}
+
+} // row_codec_internal
+
+///
+/// Appends to out the row with the fields of updates replacing those of the
+/// same name, and any others of updates added at the end. The fields that
+/// are kept are copied straight from row, which must not share out's memory.
+///
+inline void UpdateRow(const RowReader &row, const std::vector<DB::Field> &updates,
+                      std::string &out) {
+  row_codec_internal::UpdateRow(row, updates.size(),
+      [&updates](size_t j) -> const std::string & { return updates[j].name; },
+      [&updates](size_t j) -> const std::string & { return updates[j].value; }, out);
+}
+
+///
+/// As above, with the updates in a row of their own.
+///
+inline void UpdateRow(const RowReader &row, const RowReader &updates, std::string &out) {
+  row_codec_internal::UpdateRow(row, updates.size(),
+      [&updates](size_t j) { return updates.name(j); },
+      [&updates](size_t j) { return updates.value(j); }, out);
+}
+
+} // ycsbc
+
+#endif // YCSB_C_ROW_CODEC_H_
@@ -0,0 +1,41 @@
+//
+//  sequential_generator.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_SEQUENTIAL_GENERATOR_H_
+#define YCSB_C_SEQUENTIAL_GENERATOR_H_
+
+#include "generator.h"
+
+#include <atomic>
+
+namespace ycsbc {
+
+///
+/// Walks through the range in order, shared by all threads, and starts
+/// over at the beginning after the end.
+///
+class SequentialGenerator : public Generator<uint64_t> {
+ public:
+  // Both min and max are inclusive
+  SequentialGenerator(uint64_t min, uint64_t max)
+      : min_(min), items_(max - min + 1), counter_(0) {}
+
+  uint64_t Next() {
+    return min_ + counter_.fetch_add(1, std::memory_order_relaxed) % items_;
+  }
+
+  uint64_t Last() {
+    return min_ + (counter_.load(std::memory_order_relaxed) + items_ - 1) % items_;
+  }
+
+ private:
+  const uint64_t min_;
+  const uint64_t items_;
+  std::atomic<uint64_t> counter_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_SEQUENTIAL_GENERATOR_H_
@@ -0,0 +1,248 @@
+//
+//  trace_format.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_TRACE_FORMAT_H_
+#define YCSB_C_TRACE_FORMAT_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// Binary operation traces. A trace file is the 8-byte magic followed by
+/// blocks, each a fixed header and a run of records. Blocks decode on their
+/// own, so replay threads can claim them independently. Fixed-width
+/// integers are little-endian.
+///
+/// Block header:
+///   uint32 payload bytes following the header
+///   uint32 number of records
+///   uint32 thread that issued the operations
+///   uint32 reserved, zero
+///   uint64 timestamp of the block in nanoseconds, records are relative to it
+///
+/// Record, all varints:
+///   op | flags << 4               op is an Operation, flags are kTrace*
+///   timestamp delta               nanoseconds since the previous record
+///   key                           with kTraceKeyBytes: length, then the bytes;
+///                                 otherwise the zigzag delta of the key number
+///                                 from the previous record
+///   value size                    bytes written, or records scanned
+///   field                         with kTraceField: index of the single field
+///                                 read or written; otherwise all fields
+///
+namespace trace {
+
+inline constexpr char kMagic[8] = {'Y', 'C', 'S', 'B', 'T', 'R', 'C', '1'};
+inline constexpr size_t kBlockHeaderSize = 24;
+
+enum Flags : uint32_t {
+  kTraceKeyBytes = 1,
+  kTraceField = 2,
+};
+
+struct BlockHeader {
+  uint32_t payload_size;
+  uint32_t num_records;
+  uint32_t thread;
+  uint64_t timestamp;
+};
+
+///
+/// One operation of a trace. With key_bytes set, key holds the key itself;
+/// otherwise key_num is the key number of the workload.
+///
+struct Record {
+  int op;
+  uint64_t timestamp;
+  bool key_bytes;
+  const char *key;
+  size_t key_len;
+  uint64_t key_num;
+  uint64_t value_size;
+  int field; // -1 for all fields
+};
+
+inline void PutFixed32(char *p, uint32_t v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+inline void PutFixed64(char *p, uint64_t v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+inline uint32_t GetFixed32(const char *p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint64_t GetFixed64(const char *p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline void PutVarint(std::string &out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<char>(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back(static_cast<char>(v));
+}
+
+///
+/// Decodes a varint at p, not reading past limit.
+///
+inline const char *GetVarint(const char *p, const char *limit, uint64_t &v) {
+  v = 0;
+  for (int shift = 0; shift < 64 && p < limit; shift += 7) {
+    uint64_t byte = static_cast<unsigned char>(*p++);
+    v |= (byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return p;
+    }
+  }
+  throw utils::Exception("corrupt varint in trace");
+}
+
+inline uint64_t ZigZag(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline void EncodeBlockHeader(char *p, const BlockHeader &header) {
+  PutFixed32(p, header.payload_size);
+  PutFixed32(p + 4, header.num_records);
+  PutFixed32(p + 8, header.thread);
+  PutFixed32(p + 12, 0);
+  PutFixed64(p + 16, header.timestamp);
+}
+
+inline BlockHeader DecodeBlockHeader(const char *p) {
+  return {GetFixed32(p), GetFixed32(p + 4), GetFixed32(p + 8), GetFixed64(p + 16)};
+}
+
+///
+/// Encodes records with key numbers into one block.
+///
+class BlockBuilder {
+ public:
+  explicit BlockBuilder(uint32_t thread) : thread_(thread) { Clear(); }
+
+  void Add(int op, uint64_t timestamp, uint64_t key_num, uint64_t value_size, int field) {
+    if (num_records_ == 0) {
+      base_timestamp_ = last_timestamp_ = timestamp;
+    }
+    uint32_t flags = field >= 0 ? kTraceField : 0;
+    PutVarint(data_, op | flags << 4);
+    PutVarint(data_, timestamp - last_timestamp_);
+    PutVarint(data_, ZigZag(static_cast<int64_t>(key_num - last_key_num_)));
+    PutVarint(data_, value_size);
+    if (field >= 0) {
+      PutVarint(data_, field);
+    }
+    last_timestamp_ = timestamp;
+    last_key_num_ = key_num;
+    num_records_++;
+  }
+
+  bool empty() const { return num_records_ == 0; }
+  size_t size() const { return data_.size(); }
+
+  ///
+  /// Completes the header and returns the block, ready to be written.
+  ///
+  std::string &Finish() {
+    EncodeBlockHeader(&data_[0], {static_cast<uint32_t>(data_.size() - kBlockHeaderSize),
+                                  num_records_, thread_, base_timestamp_});
+    return data_;
+  }
+
+  void Clear() {
+    data_.assign(kBlockHeaderSize, '\0');
+    num_records_ = 0;
+    last_key_num_ = 0;
+  }
+
+ private:
+  const uint32_t thread_;
+  std::string data_;
+  uint32_t num_records_;
+  uint64_t base_timestamp_;
+  uint64_t last_timestamp_;
+  uint64_t last_key_num_;
+};
+
+///
+/// Decodes the records of one block in order, without copying keys.
+///
+class BlockReader {
+ public:
+  BlockReader() : p_(nullptr), limit_(nullptr), remaining_(0) {}
+  BlockReader(const char *block) {
+    BlockHeader header = DecodeBlockHeader(block);
+    p_ = block + kBlockHeaderSize;
+    limit_ = p_ + header.payload_size;
+    remaining_ = header.num_records;
+    timestamp_ = header.timestamp;
+    key_num_ = 0;
+  }
+
+  bool Next(Record &record) {
+    if (remaining_ == 0) {
+      return false;
+    }
+    remaining_--;
+    uint64_t tag, delta, v;
+    p_ = GetVarint(p_, limit_, tag);
+    record.op = tag & 0xf;
+    p_ = GetVarint(p_, limit_, delta);
+    timestamp_ += delta;
+    record.timestamp = timestamp_;
+    record.key_bytes = (tag >> 4) & kTraceKeyBytes;
+    if (record.key_bytes) {
+      p_ = GetVarint(p_, limit_, v);
+      if (v > static_cast<uint64_t>(limit_ - p_)) {
+        throw utils::Exception("corrupt key in trace");
+      }
+      record.key = p_;
+      record.key_len = v;
+      p_ += v;
+    } else {
+      p_ = GetVarint(p_, limit_, v);
+      key_num_ += UnZigZag(v);
+      record.key_num = key_num_;
+    }
+    p_ = GetVarint(p_, limit_, record.value_size);
+    record.field = -1;
+    if ((tag >> 4) & kTraceField) {
+      p_ = GetVarint(p_, limit_, v);
+      record.field = static_cast<int>(v);
+    }
+    return true;
+  }
+
+ private:
+  const char *p_;
+  const char *limit_;
+  uint32_t remaining_;
+  uint64_t timestamp_;
+  uint64_t key_num_;
+};
+
+} // trace
+
+} // ycsbc
+
+#endif // YCSB_C_TRACE_FORMAT_H_
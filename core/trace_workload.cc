@@ -0,0 +1,315 @@
+//
+//  trace_workload.cc
+//  YCSB-cpp
+//
+
+#include "trace_workload.h"
+#include "db_wrapper.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ycsbc {
+
+const std::string TraceWorkload::TRACE_FILE_PROPERTY = "trace.file";
+const std::string TraceWorkload::TRACE_SPEED_PROPERTY = "trace.speed";
+const std::string TraceWorkload::TRACE_SPEED_DEFAULT = "1";
+
+namespace {
+  // Replay position and operation arguments of a client thread
+  struct ReplayState {
+    const TraceWorkload *owner = nullptr;
+    trace::BlockReader reader;
+    trace::Record next;
+    bool has_next = false;
+
+    std::string key;
+    std::vector<std::string> fields;
+    std::vector<DB::Field> values;
+    std::vector<DB::Field> result;
+    std::vector<std::vector<DB::Field>> scan_result;
+  };
+
+  thread_local ReplayState replay;
+
+  // Arguments of an asynchronous operation, kept alive until it completes
+  struct AsyncOp {
+    std::string key;
+    std::vector<std::string> fields;
+    std::vector<DB::Field> values;
+    std::vector<DB::Field> result;
+    std::vector<std::vector<DB::Field>> scan_result;
+  };
+} // anonymous
+
+TraceWorkload::~TraceWorkload() {
+  if (data_ != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char *>(data_), size_);
+#endif
+  }
+}
+
+void TraceWorkload::Open(const utils::Properties &p) {
+  std::string path = p.GetProperty(TRACE_FILE_PROPERTY, "");
+  if (path == "") {
+    throw utils::Exception("the trace workload needs " + TRACE_FILE_PROPERTY);
+  }
+  speed_ = std::stod(p.GetProperty(TRACE_SPEED_PROPERTY, TRACE_SPEED_DEFAULT));
+  if (speed_ < 0) {
+    throw utils::Exception("trace speed must not be negative");
+  }
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw utils::Exception("cannot open trace " + path);
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) ||
+      file_size.QuadPart < static_cast<LONGLONG>(sizeof(trace::kMagic))) {
+    CloseHandle(file);
+    throw utils::Exception("not a trace: " + path);
+  }
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  // the view keeps the mapping and the file open once their handles are closed
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  void *data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (mapping != nullptr) {
+    CloseHandle(mapping);
+  }
+  if (data == nullptr) {
+    throw utils::Exception("cannot map trace " + path);
+  }
+  data_ = static_cast<const char *>(data);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw utils::Exception("cannot open trace " + path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(trace::kMagic))) {
+    close(fd);
+    throw utils::Exception("not a trace: " + path);
+  }
+  size_ = st.st_size;
+  void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw utils::Exception("cannot map trace " + path);
+  }
+  data_ = static_cast<const char *>(data);
+  madvise(data, size_, MADV_SEQUENTIAL);
+#endif
+  if (std::memcmp(data_, trace::kMagic, sizeof(trace::kMagic)) != 0) {
+    throw utils::Exception("not a trace: " + path);
+  }
+
+  // index the blocks, so that threads can claim them with one atomic increment
+  size_t offset = sizeof(trace::kMagic);
+  first_timestamp_ = UINT64_MAX;
+  while (offset < size_) {
+    if (size_ - offset < trace::kBlockHeaderSize) {
+      throw utils::Exception("truncated trace: " + path);
+    }
+    trace::BlockHeader header = trace::DecodeBlockHeader(data_ + offset);
+    if (size_ - offset - trace::kBlockHeaderSize < header.payload_size) {
+      throw utils::Exception("truncated trace: " + path);
+    }
+    blocks_.push_back(data_ + offset);
+    num_records_ += header.num_records;
+    first_timestamp_ = std::min(first_timestamp_, header.timestamp);
+    offset += trace::kBlockHeaderSize + header.payload_size;
+  }
+}
+
+void TraceWorkload::Init(const utils::Properties &p) {
+  if (data_ == nullptr) {
+    Open(p);
+  }
+  if (p.ContainsKey(OPERATION_COUNT_PROPERTY)) {
+    CoreWorkload::Init(p);
+  } else {
+    utils::Properties props = p;
+    props.SetProperty(OPERATION_COUNT_PROPERTY, std::to_string(num_records_));
+    CoreWorkload::Init(props);
+  }
+}
+
+bool TraceWorkload::NextRecord(trace::Record &record) {
+  if (Exhausted()) {
+    return false;
+  }
+  record = replay.next;
+  replay.has_next = false;
+  if (speed_ > 0) {
+    // the trace starts with the first operation replayed
+    std::call_once(start_once_, [this]() { start_ = std::chrono::steady_clock::now(); });
+    auto offset = std::chrono::nanoseconds(
+        static_cast<int64_t>((record.timestamp - first_timestamp_) / speed_));
+    std::chrono::steady_clock::time_point t = start_ + offset;
+    std::this_thread::sleep_until(t);
+    // a replay that falls behind reports the delay as latency
+    DBWrapper::SetIntendedStart(t);
+  }
+  return true;
+}
+
+bool TraceWorkload::Exhausted() {
+  if (replay.owner != this) {
+    replay.owner = this;
+    replay.reader = trace::BlockReader();
+    replay.has_next = false;
+  }
+  while (!replay.has_next) {
+    if (replay.reader.Next(replay.next)) {
+      replay.has_next = true;
+      break;
+    }
+    size_t block = next_block_.fetch_add(1, std::memory_order_relaxed);
+    if (block >= blocks_.size()) {
+      return true;
+    }
+    replay.reader = trace::BlockReader(blocks_[block]);
+  }
+  return false;
+}
+
+void TraceWorkload::BuildTraceKey(const trace::Record &record, std::string &key) {
+  if (record.key_bytes) {
+    key.assign(record.key, record.key_len);
+  } else {
+    BuildKeyName(record.key_num, key);
+  }
+}
+
+void TraceWorkload::BuildTraceValues(const trace::Record &record, std::vector<DB::Field> &values) {
+  if (record.field >= 0) {
+    values.resize(1);
+    values[0].name.assign(field_names_[record.field % field_count_]);
+    value_pool_->Fill(values[0].value, record.value_size);
+    return;
+  }
+  values.resize(field_count_);
+  for (int i = 0; i < field_count_; i++) {
+    size_t len = record.value_size / field_count_ + (i == 0 ? record.value_size % field_count_ : 0);
+    values[i].name.assign(field_names_[i]);
+    value_pool_->Fill(values[i].value, len);
+  }
+}
+
+bool TraceWorkload::DoTransaction(DB &db) {
+  trace::Record record;
+  if (!NextRecord(record)) {
+    return false;
+  }
+  BuildTraceKey(record, replay.key);
+  const std::vector<std::string> *fields = nullptr;
+  if (record.field >= 0) {
+    replay.fields.assign(1, field_names_[record.field % field_count_]);
+    fields = &replay.fields;
+  }
+
+  DB::Status status;
+  switch (record.op) {
+    case READ:
+      replay.result.clear();
+      status = db.Read(table_name_, replay.key, fields, replay.result);
+      break;
+    case UPDATE:
+      BuildTraceValues(record, replay.values);
+      status = db.Update(table_name_, replay.key, replay.values);
+      break;
+    case INSERT:
+      BuildTraceValues(record, replay.values);
+      status = db.Insert(table_name_, replay.key, replay.values);
+      break;
+    case SCAN:
+      replay.scan_result.clear();
+      status = db.Scan(table_name_, replay.key, record.value_size, fields, replay.scan_result);
+      break;
+    case READMODIFYWRITE:
+      replay.result.clear();
+      db.Read(table_name_, replay.key, fields, replay.result);
+      BuildTraceValues(record, replay.values);
+      status = db.Update(table_name_, replay.key, replay.values);
+      break;
+    case DELETE:
+      status = db.Delete(table_name_, replay.key);
+      break;
+    default:
+      throw utils::Exception("Unknown operation in trace: " + std::to_string(record.op));
+  }
+  return status == DB::kOK;
+}
+
+// records are replayed one key at a time, batched or not
+int TraceWorkload::DoBatchTransaction(DB &db, int /*count*/) {
+  DoTransaction(db);
+  return 1;
+}
+
+void TraceWorkload::DoTransactionAsync(DB &db, std::function<void(bool)> done) {
+  trace::Record record;
+  if (!NextRecord(record)) {
+    done(false);
+    return;
+  }
+  auto op = std::make_shared<AsyncOp>();
+  auto complete = [op, done](DB::Status s) { done(s == DB::kOK); };
+  BuildTraceKey(record, op->key);
+  const std::vector<std::string> *fields = nullptr;
+  if (record.field >= 0) {
+    op->fields.push_back(field_names_[record.field % field_count_]);
+    fields = &op->fields;
+  }
+
+  switch (record.op) {
+    case READ:
+      db.ReadAsync(table_name_, op->key, fields, op->result, complete);
+      break;
+    case UPDATE:
+      BuildTraceValues(record, op->values);
+      db.UpdateAsync(table_name_, op->key, op->values, complete);
+      break;
+    case INSERT:
+      BuildTraceValues(record, op->values);
+      db.InsertAsync(table_name_, op->key, op->values, complete);
+      break;
+    case SCAN:
+      db.ScanAsync(table_name_, op->key, record.value_size, fields, op->scan_result, complete);
+      break;
+    case READMODIFYWRITE: {
+      BuildTraceValues(record, op->values);
+      DB *dbp = &db;
+      db.ReadAsync(table_name_, op->key, fields, op->result, [this, dbp, op, complete](DB::Status) {
+        dbp->UpdateAsync(table_name_, op->key, op->values, complete);
+      });
+      break;
+    }
+    case DELETE:
+      db.DeleteAsync(table_name_, op->key, complete);
+      break;
+    default:
+      throw utils::Exception("Unknown operation in trace: " + std::to_string(record.op));
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,89 @@
+//
+//  trace_workload.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_TRACE_WORKLOAD_H_
+#define YCSB_C_TRACE_WORKLOAD_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "trace_format.h"
+
+namespace ycsbc {
+
+///
+/// Replays the operations of a binary trace (see trace_format.h) in the
+/// transaction phase. The trace is memory-mapped and its blocks are claimed
+/// by the client threads in file order. Records with key numbers and the
+/// load phase use the key names, fields and values of CoreWorkload.
+///
+class TraceWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the trace file to replay.
+  ///
+  static const std::string TRACE_FILE_PROPERTY;
+
+  ///
+  /// The name of the property for the replay speed relative to the
+  /// timestamps of the trace, e.g. 2 for twice as fast.
+  /// 0 replays as fast as possible.
+  ///
+  static const std::string TRACE_SPEED_PROPERTY;
+  static const std::string TRACE_SPEED_DEFAULT;
+
+  TraceWorkload() : data_(nullptr), size_(0), next_block_(0), num_records_(0),
+                    first_timestamp_(0), speed_(0) {}
+  ~TraceWorkload();
+
+  ///
+  /// Maps and indexes the trace file. Init() opens it if this has not been
+  /// called, and replays the whole trace unless operationcount is given.
+  ///
+  void Open(const utils::Properties &p);
+  void Init(const utils::Properties &p) override;
+
+  bool DoTransaction(DB &db) override;
+  int DoBatchTransaction(DB &db, int count) override;
+  void DoTransactionAsync(DB &db, std::function<void(bool)> done) override;
+  bool Exhausted() override;
+
+  ///
+  /// Returns the number of operations in the trace.
+  ///
+  uint64_t num_records() const { return num_records_; }
+
+ private:
+  ///
+  /// Takes the next record of the calling thread, claiming a new block when
+  /// its block is used up, and waits for its time if the replay is timed.
+  /// Returns false at the end of the trace.
+  ///
+  bool NextRecord(trace::Record &record);
+  void BuildTraceKey(const trace::Record &record, std::string &key);
+  ///
+  /// Replaces values with the fields written by the record, spreading its
+  /// value size over all fields unless it writes a single one.
+  ///
+  void BuildTraceValues(const trace::Record &record, std::vector<DB::Field> &values);
+
+  const char *data_;
+  size_t size_;
+  std::vector<const char *> blocks_;
+  std::atomic<size_t> next_block_;
+  uint64_t num_records_;
+  uint64_t first_timestamp_;
+  double speed_;
+  std::once_flag start_once_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_TRACE_WORKLOAD_H_
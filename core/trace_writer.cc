@@ -0,0 +1,106 @@
+//
+//  trace_writer.cc
+//  YCSB-cpp
+//
+
+#include "trace_writer.h"
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+const std::string TraceWriter::TRACE_RECORD_PROPERTY = "trace.record";
+
+namespace {
+  struct LocalBlock {
+    const TraceWriter *owner = nullptr;
+    trace::BlockBuilder *block = nullptr;
+  };
+
+  thread_local LocalBlock local;
+} // anonymous
+
+TraceWriter *TraceWriter::Create(const utils::Properties &props) {
+  std::string path = props.GetProperty(TRACE_RECORD_PROPERTY, "");
+  if (path == "") {
+    return nullptr;
+  }
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    throw utils::Exception("cannot open " + path);
+  }
+  if (std::fwrite(trace::kMagic, sizeof(trace::kMagic), 1, file) != 1) {
+    std::fclose(file);
+    throw utils::Exception("cannot write " + path);
+  }
+  return new TraceWriter(path, file);
+}
+
+TraceWriter::TraceWriter(const std::string &path, std::FILE *file)
+    : path_(path), file_(file), start_(std::chrono::steady_clock::now()), closing_(false), failed_(false) {
+  writer_ = std::thread(&TraceWriter::WriterThread, this);
+}
+
+void TraceWriter::Close() {
+  for (auto &block : blocks_) {
+    if (!block->empty()) {
+      Submit(*block);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  cv_.notify_one();
+  writer_.join();
+  if (std::fclose(file_) != 0 || failed_) {
+    throw utils::Exception("cannot write " + path_);
+  }
+}
+
+trace::BlockBuilder &TraceWriter::LocalBlock() {
+  if (local.owner != this) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocks_.emplace_back(new trace::BlockBuilder(blocks_.size()));
+    local.owner = this;
+    local.block = blocks_.back().get();
+  }
+  return *local.block;
+}
+
+void TraceWriter::Submit(trace::BlockBuilder &block) {
+  std::string data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+      data.swap(free_.back());
+      free_.pop_back();
+    }
+  }
+  // hand over the encoded block and keep a spare buffer in its place
+  data.swap(block.Finish());
+  block.Clear();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(data));
+  }
+  cv_.notify_one();
+}
+
+void TraceWriter::WriterThread() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      break;
+    }
+    std::string data = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    bool ok = std::fwrite(data.data(), data.size(), 1, file_) == 1;
+    lock.lock();
+    failed_ = failed_ || !ok;
+    free_.push_back(std::move(data));
+  }
+}
+
+} // ycsbc
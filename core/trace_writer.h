@@ -0,0 +1,89 @@
+//
+//  trace_writer.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_TRACE_WRITER_H_
+#define YCSB_C_TRACE_WRITER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trace_format.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Records the operations of the transaction phase as a trace that
+/// TraceWorkload replays. Every thread encodes into a block of its own;
+/// full blocks are handed to a background thread that writes them, so
+/// recording an operation takes no lock and no system call.
+///
+class TraceWriter {
+ public:
+  static const std::string TRACE_RECORD_PROPERTY;
+
+  ///
+  /// Returns nullptr if no trace is to be recorded.
+  ///
+  static TraceWriter *Create(const utils::Properties &props);
+
+  ///
+  /// Writes the blocks still held by the threads and closes the file.
+  /// Called once, after all recording threads are done.
+  ///
+  void Close();
+
+  ///
+  /// Records an operation of the calling thread. field is the index of
+  /// the single field read or written, or -1 for all fields.
+  ///
+  void Record(int op, uint64_t key_num, uint64_t value_size, int field) {
+    trace::BlockBuilder &block = LocalBlock();
+    uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+    block.Add(op, now, key_num, value_size, field);
+    if (block.size() >= kBlockSize) {
+      Submit(block);
+    }
+  }
+
+ private:
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  TraceWriter(const std::string &path, std::FILE *file);
+
+  trace::BlockBuilder &LocalBlock();
+  ///
+  /// Queues the block for writing and clears it for reuse.
+  ///
+  void Submit(trace::BlockBuilder &block);
+  void WriterThread();
+
+  const std::string path_;
+  std::FILE *file_;
+  const std::chrono::steady_clock::time_point start_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::string> queue_;
+  std::vector<std::string> free_; // written buffers, reused by Submit
+  bool closing_;
+  bool failed_;
+  std::thread writer_;
+
+  // blocks of all threads that recorded, flushed by the destructor
+  std::vector<std::unique_ptr<trace::BlockBuilder>> blocks_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_TRACE_WRITER_H_
@@ -12,26 +12,27 @@
 #include "generator.h"
 
 #include <atomic>
-#include <random>
+
+#include "utils/random.h"
 
 namespace ycsbc {
 
 class UniformGenerator : public Generator<uint64_t> {
  public:
   // Both min and max are inclusive
-  UniformGenerator(uint64_t min, uint64_t max) : dist_(min, max) { Next(); }
+  UniformGenerator(uint64_t min, uint64_t max) : min_(min), range_(max - min + 1) { Next(); }
 
   uint64_t Next();
   uint64_t Last();
 
  private:
-  std::mt19937_64 generator_;
-  std::uniform_int_distribution<uint64_t> dist_;
-  uint64_t last_int_;
+  const uint64_t min_;
+  const uint64_t range_; // zero for the full 64-bit range
+  std::atomic<uint64_t> last_int_;
 };
 
 inline uint64_t UniformGenerator::Next() {
-  return last_int_ = dist_(generator_);
+  return last_int_ = min_ + utils::ThreadRandom().Uniform(range_);
 }
 
 inline uint64_t UniformGenerator::Last() {
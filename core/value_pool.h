@@ -0,0 +1,83 @@
+//
+//  value_pool.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_VALUE_POOL_H_
+#define YCSB_C_VALUE_POOL_H_
+
+#include "random_byte_generator.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace ycsbc {
+
+///
+/// Pre-generated random bytes that field values are copied from, so that
+/// building a value costs a memcpy rather than one RNG call per byte.
+///
+/// Values can be made compressible by a target ratio: each value then starts
+/// with len / ratio random bytes, which are repeated to fill the rest. The
+/// repeats are what LZ-style compressors (snappy, lz4) remove; compressors
+/// that also entropy-code, such as zstd or zlib, shrink the printable random
+/// bytes somewhat further.
+///
+class ValuePool {
+ public:
+  ///
+  /// @param size The number of distinct start offsets.
+  /// @param max_len The longest value copied in one piece.
+  /// @param compressibility The ratio values compress by, at least 1.
+  ///
+  ValuePool(size_t size, size_t max_len, double compressibility = 1)
+      : size_(std::max<size_t>(size, 1)), max_len_(std::max<size_t>(max_len, 1)),
+        random_fraction_(1 / std::max(compressibility, 1.0)) {
+    RandomByteGenerator byte_generator;
+    data_.resize(size_ + max_len_);
+    std::generate_n(data_.begin(), size_, [&]() { return byte_generator.Next(); });
+    // values starting near the end wrap around to the start
+    for (size_t i = 0; i < max_len_; i++) {
+      data_[size_ + i] = data_[i];
+    }
+  }
+
+  ///
+  /// Replaces value with len bytes from a random offset of the pool.
+  ///
+  void Fill(std::string &value, size_t len) const {
+    value.clear();
+    if (random_fraction_ == 1) {
+      AppendRandom(value, len);
+      return;
+    }
+    value.reserve(len);
+    size_t random_len = std::max<size_t>(len * random_fraction_ + 0.5, 1);
+    AppendRandom(value, std::min(random_len, len));
+    // doubling keeps the period, so the random bytes repeat back to back
+    while (value.size() < len) {
+      value.append(value, 0, std::min(value.size(), len - value.size()));
+    }
+  }
+
+ private:
+  void AppendRandom(std::string &value, size_t len) const {
+    while (len > 0) {
+      size_t n = std::min(len, max_len_);
+      size_t offset = utils::ThreadLocalRandomInt() % size_;
+      value.append(data_.data() + offset, n);
+      len -= n;
+    }
+  }
+
+  const size_t size_;
+  const size_t max_len_;
+  const double random_fraction_;
+  std::vector<char> data_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_VALUE_POOL_H_
@@ -15,34 +15,62 @@
 #include <thread>
 #include <future>
 #include <chrono>
+#include <filesystem>
 #include <iomanip>
+#include <set>
 
 #include "client.h"
 #include "core_workload.h"
 #include "db_factory.h"
+#include "interval_log.h"
 #include "measurements.h"
+#include "result_export.h"
+#include "trace_workload.h"
+#include "trace_writer.h"
+#include "utils/arrival.h"
 #include "utils/countdown_latch.h"
+#include "utils/latency_clock.h"
+#include "utils/random.h"
 #include "utils/rate_limit.h"
 #include "utils/timer.h"
 #include "utils/utils.h"
+#include "utils/work_counter.h"
 
 void UsageMessage(const char *command);
 bool StrStartWith(const char *str, const char *pre);
-void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props);
+void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props,
+                      std::set<std::string> &cmdline_keys);
 
-void StatusThread(ycsbc::Measurements *measurements, ycsbc::utils::CountDownLatch *latch, int interval) {
+// Rounds a chunk of work up to whole batches, since a batch does not span two chunks
+int64_t WholeBatches(int64_t chunk, int batch_size) {
+  return (chunk + batch_size - 1) / batch_size * batch_size;
+}
+
+void StatusThread(ycsbc::Measurements *measurements, ycsbc::IntervalLog *interval_log,
+                  std::string phase, bool show_status, ycsbc::utils::CountDownLatch *latch, int interval) {
   using namespace std::chrono;
   time_point<system_clock> start = system_clock::now();
+  if (interval_log != nullptr) {
+    interval_log->Begin(phase, start);
+  }
   bool done = false;
   while (1) {
     time_point<system_clock> now = system_clock::now();
     std::time_t now_c = system_clock::to_time_t(now);
     duration<double> elapsed_time = now - start;
 
-    std::cout << std::put_time(std::localtime(&now_c), "%F %T") << ' '
-              << static_cast<long long>(elapsed_time.count()) << " sec: ";
+    ycsbc::MeasurementStats interval_stats, cumulative_stats;
+    measurements->Tick(interval_stats, cumulative_stats);
+
+    if (show_status) {
+      std::cout << std::put_time(std::localtime(&now_c), "%F %T") << ' '
+                << static_cast<long long>(elapsed_time.count()) << " sec: ";
 
-    std::cout << measurements->GetStatusMsg() << std::endl;
+      std::cout << ycsbc::Measurements::FormatStatus(cumulative_stats) << std::endl;
+    }
+    if (interval_log != nullptr) {
+      interval_log->Write(now, interval_stats, cumulative_stats);
+    }
 
     if (done) {
       break;
@@ -51,6 +79,15 @@ void StatusThread(ycsbc::Measurements *measurements, ycsbc::utils::CountDownLatc
   };
 }
 
+// Runs a client function on a new thread whose random generator draws stream
+template <typename F, typename... Args>
+std::future<int> StartClient(uint64_t stream, F f, Args... args) {
+  return std::async(std::launch::async, [=]() {
+    ycsbc::utils::ThreadRandomState::SeedThread(stream);
+    return f(args...);
+  });
+}
+
 void RateLimitThread(std::string rate_file, std::vector<ycsbc::utils::RateLimiter *> rate_limiters,
                      ycsbc::utils::CountDownLatch *latch) {
   std::ifstream ifs;
@@ -84,9 +121,32 @@ void RateLimitThread(std::string rate_file, std::vector<ycsbc::utils::RateLimite
   }
 }
 
+// Ends the warm-up and stops the clients when the time budget expires.
+// Returns the time in seconds from the start of the run to the end of the warm-up.
+double TimeLimitThread(ycsbc::Measurements *measurements, ycsbc::RunControl *control, int warmup_time,
+                       int max_execution_time, ycsbc::utils::CountDownLatch *latch) {
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  double warmup_elapsed = 0;
+  if (warmup_time > 0) {
+    if (latch->AwaitFor(warmup_time)) {
+      return timer.End();
+    }
+    measurements->Reset();
+    control->measuring = true;
+    warmup_elapsed = timer.End();
+  }
+  if (max_execution_time > 0 && !latch->AwaitFor(max_execution_time - warmup_time)) {
+    control->stop = true;
+  }
+  return warmup_elapsed;
+}
+
 int main(const int argc, const char *argv[]) {
   ycsbc::utils::Properties props;
-  ParseCommandLine(argc, argv, props);
+  // properties given with -p, which take precedence over workload files
+  std::set<std::string> cmdline_keys;
+  ParseCommandLine(argc, argv, props, cmdline_keys);
 
   const bool do_load = (props.GetProperty("doload", "false") == "true");
   const bool do_transaction = (props.GetProperty("dotransaction", "false") == "true");
@@ -95,7 +155,48 @@ int main(const int argc, const char *argv[]) {
     exit(1);
   }
 
+  // directory to save the loaded database into, and to restore it from
+  const std::string snapshot_dir = props.GetProperty("snapshot", "");
+  const std::string restore_dir = props.GetProperty("restore", "");
+  if (snapshot_dir != "" && !do_load) {
+    std::cerr << "-snapshot requires -load" << std::endl;
+    exit(1);
+  }
+  if (restore_dir != "" && do_load) {
+    std::cerr << "-restore cannot be combined with -load" << std::endl;
+    exit(1);
+  }
+  if (snapshot_dir != "" && std::filesystem::exists(snapshot_dir)) {
+    std::cerr << "Snapshot directory already exists: " << snapshot_dir << std::endl;
+    exit(1);
+  }
+
   const int num_threads = stoi(props.GetProperty("threadcount", "1"));
+  // asynchronous operations in flight per client thread
+  const int queue_depth = stoi(props.GetProperty("queuedepth", "1"));
+  // operations handed out to a client thread at a time
+  const int work_chunk = stoi(props.GetProperty("work.chunksize", "100"));
+
+  // seed of the random generators, recorded in the properties when chosen at random
+  if (props.ContainsKey("randomseed")) {
+    ycsbc::utils::ThreadRandomState::SetSeed(std::stoull(props["randomseed"]));
+  } else {
+    props.SetProperty("randomseed", std::to_string(ycsbc::utils::ThreadRandomState::GetSeed()));
+  }
+  ycsbc::utils::ThreadRandomState::SeedThread(0);
+
+  // clock of the operation latencies: "auto", "tsc" or "steady"
+  ycsbc::utils::LatencyClock::Init(props.GetProperty("latency.clock", "auto"),
+                                   props.GetProperty("latency.subtract_overhead", "false") == "true");
+  std::cout << "Latency clock: " << ycsbc::utils::LatencyClock::Name();
+  if (ycsbc::utils::LatencyClock::Name() == "tsc") {
+    std::cout << " (" << ycsbc::utils::LatencyClock::TicksPerNano() << " GHz)";
+  }
+  std::cout << ", overhead " << ycsbc::utils::LatencyClock::Overhead() << " ns per measurement";
+  if (ycsbc::utils::LatencyClock::Correction() > 0) {
+    std::cout << ", subtracted";
+  }
+  std::cout << std::endl;
 
   ycsbc::Measurements *measurements = ycsbc::CreateMeasurements(&props);
   if (measurements == nullptr) {
@@ -113,35 +214,89 @@ int main(const int argc, const char *argv[]) {
     dbs.push_back(db);
   }
 
-  ycsbc::CoreWorkload wl;
-  wl.Init(props);
+  // "trace" replays a trace file in the run phase, anything else generates the operations
+  ycsbc::CoreWorkload *wl;
+  if (props.GetProperty("workload", "") == "trace") {
+    ycsbc::TraceWorkload *trace = new ycsbc::TraceWorkload;
+    trace->Open(props);
+    // replay the whole trace unless -p operationcount says otherwise
+    if (cmdline_keys.count(ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY) == 0) {
+      props.SetProperty(ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY,
+                        std::to_string(trace->num_records()));
+    }
+    trace->Init(props);
+    wl = trace;
+  } else {
+    wl = new ycsbc::CoreWorkload;
+    wl->Init(props);
+  }
 
   // print status periodically
   const bool show_status = (props.GetProperty("status", "false") == "true");
   const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
+  // per-interval statistics written to files
+  ycsbc::IntervalLog *interval_log = ycsbc::IntervalLog::Create(props);
+  // structured results of all phases
+  ycsbc::ResultExporter *exporter = ycsbc::ResultExporter::Create(props, argc, argv);
+  const bool status_thread = show_status || interval_log != nullptr;
+
+  if (restore_dir != "") {
+    ycsbc::utils::Timer<double> timer;
+    timer.Start();
+    if (dbs[0]->Restore(restore_dir) != ycsbc::DB::kOK) {
+      std::cerr << "Restore is not supported by " << props["dbname"] << std::endl;
+      exit(1);
+    }
+    double runtime = timer.End();
+    std::cout << "Restore runtime(sec): " << runtime << std::endl;
+    if (exporter != nullptr) {
+      exporter->AddPhase("restore", runtime);
+    }
+  }
 
   // load phase
   if (do_load) {
     const int total_ops = stoi(props[ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY]);
+    // insert the records sorted by key through the bulk ingest path of the DB
+    const bool bulk_load = (props.GetProperty("bulkload", "false") == "true");
+    // records per bulk insert call
+    const size_t bulk_chunk = std::stoul(props.GetProperty("bulkload.chunksize", "100000"));
+
+    // keep the DB open for the snapshot
+    const bool cleanup_after_load = !do_transaction && snapshot_dir == "";
 
     ycsbc::utils::CountDownLatch latch(num_threads);
     ycsbc::utils::Timer<double> timer;
 
     timer.Start();
+    std::vector<uint64_t> bulk_keys;
+    if (bulk_load) {
+      bulk_keys = wl->SortedLoadKeys(total_ops);
+    }
+    // with key blocks, a claimed chunk of work is the block of keys it inserts
+    const int64_t load_chunk = WholeBatches(wl->insert_key_block() > 1 ? wl->insert_key_block()
+                                                                        : work_chunk, wl->batch_size());
+    ycsbc::utils::WorkCounter work(bulk_load ? bulk_keys.size() : total_ops,
+                                   bulk_load ? bulk_chunk : load_chunk);
     std::future<void> status_future;
-    if (show_status) {
-      status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
+    if (status_thread) {
+      status_future = std::async(std::launch::async, StatusThread, measurements, interval_log,
+                                 "load", show_status, &latch, status_interval);
     }
     std::vector<std::future<int>> client_threads;
     for (int i = 0; i < num_threads; ++i) {
-      int thread_ops = total_ops / num_threads;
-      if (i < total_ops % num_threads) {
-        thread_ops++;
+      if (bulk_load) {
+        client_threads.emplace_back(StartClient(1 + i, ycsbc::BulkLoadThread, dbs[i], wl,
+                                                bulk_keys.data(), &work, true, cleanup_after_load, &latch));
+      } else if (queue_depth > 1) {
+        client_threads.emplace_back(StartClient(1 + i, ycsbc::AsyncClientThread, dbs[i], wl,
+                                                &work, true, true, cleanup_after_load, &latch, nullptr,
+                                                nullptr, queue_depth, nullptr));
+      } else {
+        client_threads.emplace_back(StartClient(1 + i, ycsbc::ClientThread, dbs[i], wl,
+                                                &work, true, true, cleanup_after_load, &latch, nullptr,
+                                                nullptr, nullptr));
       }
-
-      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, true, true, !do_transaction, &latch, nullptr));
     }
     assert((int)client_threads.size() == num_threads);
 
@@ -152,13 +307,36 @@ int main(const int argc, const char *argv[]) {
     }
     double runtime = timer.End();
 
-    if (show_status) {
+    if (status_thread) {
       status_future.wait();
     }
 
     std::cout << "Load runtime(sec): " << runtime << std::endl;
     std::cout << "Load operations(ops): " << sum << std::endl;
     std::cout << "Load throughput(ops/sec): " << sum / runtime << std::endl;
+    if (exporter != nullptr) {
+      ycsbc::MeasurementStats stats;
+      measurements->GetStats(stats);
+      exporter->AddPhase("load", runtime, sum, stats);
+    }
+
+    if (snapshot_dir != "") {
+      timer.Start();
+      if (dbs[0]->Snapshot(snapshot_dir) != ycsbc::DB::kOK) {
+        std::cerr << "Snapshot is not supported by " << props["dbname"] << std::endl;
+        exit(1);
+      }
+      double snapshot_runtime = timer.End();
+      std::cout << "Snapshot runtime(sec): " << snapshot_runtime << std::endl;
+      if (exporter != nullptr) {
+        exporter->AddPhase("snapshot", snapshot_runtime);
+      }
+      if (!do_transaction) {
+        for (int i = 0; i < num_threads; i++) {
+          dbs[i]->Cleanup();
+        }
+      }
+    }
   }
 
   measurements->Reset();
@@ -171,33 +349,78 @@ int main(const int argc, const char *argv[]) {
     const int64_t ops_limit = std::stoi(props.GetProperty("limit.ops", "0"));
     // rate file path for dynamic rate limiting, format "time_stamp_sec new_ops_per_second" per line
     std::string rate_file = props.GetProperty("limit.file", "");
+    // open-loop arrival process, "fixed" or "poisson", closed-loop if empty
+    const std::string arrival_type = props.GetProperty("openloop.arrival", "");
+    // total intended ops per second of the open-loop clients
+    const double arrival_rate = std::stod(props.GetProperty("openloop.rate", "0"));
+    if (arrival_type != "" && (ops_limit > 0 || rate_file != "")) {
+      std::cerr << "openloop.arrival cannot be combined with limit.ops or limit.file" << std::endl;
+      exit(1);
+    }
+    if (arrival_type != "" && arrival_rate <= 0) {
+      std::cerr << "openloop.arrival needs a positive openloop.rate" << std::endl;
+      exit(1);
+    }
+    // seconds after which the run stops, unlimited if <= 0; includes the warm-up
+    const int max_execution_time = std::stoi(props.GetProperty("maxexecutiontime", "0"));
+    // seconds of warm-up at the start of the run, excluded from measurements
+    const int warmup_time = std::stoi(props.GetProperty("warmuptime", "0"));
+    if (max_execution_time > 0 && warmup_time >= max_execution_time) {
+      std::cerr << "warmuptime must be less than maxexecutiontime" << std::endl;
+      exit(1);
+    }
 
     const int total_ops = stoi(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
 
     ycsbc::utils::CountDownLatch latch(num_threads);
     ycsbc::utils::Timer<double> timer;
 
+    // the load phase is not recorded, recordcount and insertorder reproduce it
+    ycsbc::TraceWriter *trace_writer = ycsbc::TraceWriter::Create(props);
+    wl->set_trace_writer(trace_writer);
+
     timer.Start();
     std::future<void> status_future;
-    if (show_status) {
-      status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
+    if (status_thread) {
+      status_future = std::async(std::launch::async, StatusThread, measurements, interval_log,
+                                 "run", show_status, &latch, status_interval);
     }
+    ycsbc::RunControl control;
+    control.measuring = (warmup_time <= 0);
+    ycsbc::utils::WorkCounter work(total_ops, WholeBatches(work_chunk, wl->batch_size()));
     std::vector<std::future<int>> client_threads;
     std::vector<ycsbc::utils::RateLimiter *> rate_limiters;
+    std::vector<ycsbc::utils::ArrivalProcess *> arrivals;
     for (int i = 0; i < num_threads; ++i) {
-      int thread_ops = total_ops / num_threads;
-      if (i < total_ops % num_threads) {
-        thread_ops++;
-      }
       ycsbc::utils::RateLimiter *rlim = nullptr;
       if (ops_limit > 0 || rate_file != "") {
         int64_t per_thread_ops = ops_limit / num_threads;
         rlim = new ycsbc::utils::RateLimiter(per_thread_ops, per_thread_ops);
       }
       rate_limiters.push_back(rlim);
-      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, false, !do_load, true, &latch, rlim));
+      ycsbc::utils::ArrivalProcess *arrival = nullptr;
+      if (arrival_type != "") {
+        arrival = new ycsbc::utils::ArrivalProcess(ycsbc::utils::ArrivalProcess::ParseType(arrival_type),
+                                                   arrival_rate / num_threads);
+      }
+      arrivals.push_back(arrival);
+      // random streams of the run follow those of the load phase
+      const uint64_t stream = 1 + num_threads + i;
+      if (queue_depth > 1) {
+        client_threads.emplace_back(StartClient(stream, ycsbc::AsyncClientThread, dbs[i], wl,
+                                                &work, false, !do_load, true, &latch, rlim, arrival,
+                                                queue_depth, &control));
+      } else {
+        client_threads.emplace_back(StartClient(stream, ycsbc::ClientThread, dbs[i], wl,
+                                                &work, false, !do_load, true, &latch, rlim, arrival,
+                                                &control));
+      }
+    }
+
+    std::future<double> time_limit_future;
+    if (warmup_time > 0 || max_execution_time > 0) {
+      time_limit_future = std::async(std::launch::async, TimeLimitThread, measurements, &control,
+                                     warmup_time, max_execution_time, &latch);
     }
 
     std::future<void> rlim_future;
@@ -214,21 +437,52 @@ int main(const int argc, const char *argv[]) {
     }
     double runtime = timer.End();
 
-    if (show_status) {
+    if (trace_writer != nullptr) {
+      wl->set_trace_writer(nullptr);
+      trace_writer->Close();
+      delete trace_writer;
+    }
+
+    if (time_limit_future.valid()) {
+      double warmup_elapsed = time_limit_future.get();
+      if (!control.measuring) {
+        std::cerr << "Run finished within the warm-up time" << std::endl;
+      }
+      // report the measured window only
+      runtime -= warmup_elapsed;
+    }
+
+    if (status_thread) {
       status_future.wait();
     }
 
     std::cout << "Run runtime(sec): " << runtime << std::endl;
     std::cout << "Run operations(ops): " << sum << std::endl;
     std::cout << "Run throughput(ops/sec): " << sum / runtime << std::endl;
+    if (exporter != nullptr) {
+      ycsbc::MeasurementStats stats;
+      measurements->GetStats(stats);
+      exporter->AddPhase("run", runtime, sum, stats);
+    }
+
+    for (auto x : arrivals) {
+      delete x;
+    }
   }
 
   for (int i = 0; i < num_threads; i++) {
     delete dbs[i];
   }
+  delete wl;
+  delete interval_log;
+  if (exporter != nullptr) {
+    exporter->Write();
+    delete exporter;
+  }
 }
 
-void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props) {
+void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props,
+                      std::set<std::string> &cmdline_keys) {
   int argindex = 1;
   while (argindex < argc && StrStartWith(argv[argindex], "-")) {
     if (strcmp(argv[argindex], "-load") == 0) {
@@ -286,8 +540,27 @@ void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &pr
                      "(e.g., -p operationcount=99999)" << std::endl;
         exit(0);
       }
-      props.SetProperty(ycsbc::utils::Trim(prop.substr(0, eq)),
-                        ycsbc::utils::Trim(prop.substr(eq + 1)));
+      std::string key = ycsbc::utils::Trim(prop.substr(0, eq));
+      props.SetProperty(key, ycsbc::utils::Trim(prop.substr(eq + 1)));
+      cmdline_keys.insert(key);
+      argindex++;
+    } else if (strcmp(argv[argindex], "-snapshot") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument value for -snapshot" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("snapshot", argv[argindex]);
+      argindex++;
+    } else if (strcmp(argv[argindex], "-restore") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument value for -restore" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("restore", argv[argindex]);
       argindex++;
     } else if (strcmp(argv[argindex], "-s") == 0) {
       props.SetProperty("status", "true");
@@ -319,6 +592,8 @@ void UsageMessage(const char *command) {
       "  -p name=value: specify a property to be passed to the DB and workloads\n"
       "                 multiple properties can be specified, and override any\n"
       "                 values in the propertyfile\n"
+      "  -snapshot dir: save a copy of the loaded database into dir\n"
+      "  -restore dir: restore the database saved by -snapshot from dir instead of loading\n"
       "  -s: print status every 10 seconds (use status.interval prop to override)"
       << std::endl;
 }
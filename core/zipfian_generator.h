@@ -9,10 +9,11 @@
 #ifndef YCSB_C_ZIPFIAN_GENERATOR_H_
 #define YCSB_C_ZIPFIAN_GENERATOR_H_
 
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
-#include <mutex>
+#include <vector>
 
 #include "generator.h"
 #include "utils/utils.h"
@@ -23,27 +24,33 @@ class ZipfianGenerator : public Generator<uint64_t> {
  public:
   static constexpr double kZipfianConst = 0.99;
   static constexpr uint64_t kMaxNumItems = (UINT64_MAX >> 24);
+  static constexpr double kZetaTolerance = 1e-12;
 
   ZipfianGenerator(uint64_t num_items) :
       ZipfianGenerator(0, num_items - 1) {}
 
   ZipfianGenerator(uint64_t min, uint64_t max, double zipfian_const = kZipfianConst) :
-      ZipfianGenerator(min, max, zipfian_const, Zeta(max - min + 1, zipfian_const)) {}
-
-  ZipfianGenerator(uint64_t min, uint64_t max, double zipfian_const, double zeta_n) :
-      items_(max - min + 1), base_(min), theta_(zipfian_const), allow_count_decrease_(false) {
+      items_(max - min + 1), base_(min), theta_(zipfian_const) {
     assert(items_ >= 2 && items_ < kMaxNumItems);
 
-    zeta_2_ = Zeta(2, theta_);
-
     alpha_ = 1.0 / (1.0 - theta_);
-    zeta_n_ = zeta_n;
-    count_for_zeta_ = items_;
-    eta_ = Eta();
+    InitZeta();
+    zeta_2_ = Zeta(2);
+    zeta_n_ = Zeta(items_);
+    eta_ = Eta(items_, zeta_n_);
 
     Next();
   }
 
+  ///
+  /// Sets the bound on the absolute error of the zeta constants computed by
+  /// generators constructed afterwards. Zeta is summed exactly over the first
+  /// items only and approximated by Euler-Maclaurin summation for the rest.
+  ///
+  static void SetZetaTolerance(double tolerance) {
+    zeta_tolerance_ = tolerance;
+  }
+
   uint64_t Next(uint64_t num_items);
 
   uint64_t Next() { return Next(items_); }
@@ -51,69 +58,123 @@ class ZipfianGenerator : public Generator<uint64_t> {
   uint64_t Last();
 
  private:
-  double Eta() {
-    return (1 - std::pow(2.0 / items_, 1 - theta_)) / (1 - zeta_2_ / zeta_n_);
+  double Eta(uint64_t num, double zeta_n) const {
+    return (1 - std::pow(2.0 / num, 1 - theta_)) / (1 - zeta_2_ / zeta_n);
   }
 
   ///
-  /// Calculate the zeta constant needed for a distribution.
-  /// Do this incrementally from the last_num of items to the cur_num.
-  /// Use the zipfian constant as theta. Remember the new number of items
-  /// so that, if it is changed, we can recompute zeta.
+  /// Chooses how many items to sum exactly, the smallest power of two for
+  /// which the first omitted Euler-Maclaurin term is within the tolerance,
+  /// and precomputes the parts of the approximation that do not depend on
+  /// the number of items.
   ///
-  static double Zeta(uint64_t last_num, uint64_t cur_num, double theta, double last_zeta) {
-    double zeta = last_zeta;
-    for (uint64_t i = last_num + 1; i <= cur_num; ++i) {
-      zeta += 1 / std::pow(i, theta);
-    }
-    return zeta;
-  }
+  void InitZeta();
 
-  static double Zeta(uint64_t num, double theta) {
-    return Zeta(0, num, theta, 0);
-  }
+  ///
+  /// Returns the zeta constant of num items, sum(1 / i^theta) for i <= num,
+  /// in constant time.
+  ///
+  double Zeta(uint64_t num) const;
+
+  static inline double zeta_tolerance_ = kZetaTolerance;
 
   uint64_t items_;
   uint64_t base_; /// Min number of items to generate
 
   // Computed parameters for generating the distribution
   double theta_, zeta_n_, eta_, alpha_, zeta_2_;
-  uint64_t count_for_zeta_; /// Number of items used to compute zeta_n
-  uint64_t last_value_;
-  std::mutex mutex_;
-  bool allow_count_decrease_;
+  std::atomic<uint64_t> last_value_;
+
+  // Zeta of the first exact_terms_ items, and the constant and the
+  // coefficients of the Euler-Maclaurin approximation beyond them
+  std::vector<double> exact_zeta_;
+  uint64_t exact_terms_;
+  double zeta_const_;
+  double zeta_coef_[4];
 };
 
+inline void ZipfianGenerator::InitZeta() {
+  // Bernoulli numbers B2, B4, ..., B10 divided by their factorials
+  static constexpr double kBernoulli[] = {
+    1.0 / 6 / 2, -1.0 / 30 / 24, 1.0 / 42 / 720, -1.0 / 30 / 40320, 5.0 / 66 / 3628800
+  };
+  // the odd derivatives of x^-theta are -rising(theta, 2k-1) * x^(-theta-2k+1)
+  double rising[5];
+  double r = theta_;
+  for (int k = 0; k < 5; k++) {
+    rising[k] = r;
+    r *= (theta_ + 2 * k + 1) * (theta_ + 2 * k + 2);
+  }
+  // the remainder is about the size of the first omitted term
+  const uint64_t kMaxExactTerms = 1 << 20;
+  exact_terms_ = 8;
+  while (exact_terms_ < kMaxExactTerms &&
+         std::abs(kBernoulli[4] * rising[4]) * std::pow(exact_terms_, -theta_ - 9) > zeta_tolerance_) {
+    exact_terms_ *= 2;
+  }
+
+  exact_zeta_.resize(exact_terms_);
+  exact_zeta_[0] = 0;
+  for (uint64_t i = 1; i < exact_terms_; i++) {
+    exact_zeta_[i] = exact_zeta_[i - 1] + 1 / std::pow(i, theta_);
+  }
+
+  // sum over [k, n] = integral over [k, n] + (f(k) + f(n)) / 2
+  //                   + sum(B2j / (2j)! * (f'(2j-1)(n) - f'(2j-1)(k)))
+  const double k = exact_terms_;
+  const double fk = std::pow(k, -theta_);
+  zeta_const_ = exact_zeta_[exact_terms_ - 1] - fk * k / (1 - theta_) + fk / 2;
+  double kpow = fk / k;
+  for (int j = 0; j < 4; j++) {
+    zeta_coef_[j] = -kBernoulli[j] * rising[j];
+    zeta_const_ -= zeta_coef_[j] * kpow;
+    kpow /= k * k;
+  }
+}
+
+inline double ZipfianGenerator::Zeta(uint64_t num) const {
+  if (num < exact_terms_) {
+    return exact_zeta_[num];
+  }
+  const double n = num;
+  const double fn = std::pow(n, -theta_);
+  double zeta = zeta_const_ + fn * n / (1 - theta_) + fn / 2;
+  double npow = fn / n;
+  for (int j = 0; j < 4; j++) {
+    zeta += zeta_coef_[j] * npow;
+    npow /= n * n;
+  }
+  return zeta;
+}
+
 inline uint64_t ZipfianGenerator::Next(uint64_t num) {
   assert(num >= 2 && num < kMaxNumItems);
-  if (num != count_for_zeta_) {
-    // recompute zeta and eta
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (num > count_for_zeta_) {
-      zeta_n_ = Zeta(count_for_zeta_, num, theta_, zeta_n_);
-      count_for_zeta_ = num;
-      eta_ = Eta();
-    } else if (num < count_for_zeta_ && allow_count_decrease_) {
-      // TODO
-    }
+  double zeta_n = zeta_n_;
+  double eta = eta_;
+  if (num != items_) {
+    // computed on the fly rather than cached, so that a growing number of
+    // items never makes client threads wait for each other
+    zeta_n = Zeta(num);
+    eta = Eta(num, zeta_n);
   }
 
   double u = utils::ThreadLocalRandomDouble();
-  double uz = u * zeta_n_;
+  double uz = u * zeta_n;
 
+  uint64_t value;
   if (uz < 1.0) {
-    return last_value_ = base_;
+    value = base_;
+  } else if (uz < zeta_2_) {
+    value = base_ + 1;
+  } else {
+    value = base_ + num * std::pow(eta * u - eta + 1, alpha_);
   }
-
-  if (uz < 1.0 + std::pow(0.5, theta_)) {
-    return last_value_ = base_ + 1;
-  }
-
-  return last_value_ = base_ + num * std::pow(eta_ * u - eta_ + 1, alpha_);
+  last_value_.store(value, std::memory_order_relaxed);
+  return value;
 }
 
 inline uint64_t ZipfianGenerator::Last() {
-  return last_value_;
+  return last_value_.load(std::memory_order_relaxed);
 }
 
 }
@@ -1,5 +1,6 @@
 #include "hashdb/hashdb_db.h"
 #include "core/db_factory.h"
+#include "core/row_codec.h"
 
 namespace {
 const std::string PROP_NAME = "hashdb.dbname";
@@ -263,62 +264,6 @@ void HashdbDB::Cleanup() {
     delete db_;
 }
 
-void HashdbDB::SerializeRow(const std::vector<Field> &values,
-                            std::string *data) {
-    for (const Field &field : values) {
-        uint32_t len = field.name.size();
-        data->append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
-        data->append(field.name.data(), field.name.size());
-        len = field.value.size();
-        data->append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
-        data->append(field.value.data(), field.value.size());
-    }
-}
-
-void HashdbDB::DeserializeRowFilter(std::vector<Field> *values,
-                                    const std::string &data,
-                                    const std::vector<std::string> &fields) {
-    const char *p = data.data();
-    const char *lim = p + data.size();
-
-    std::vector<std::string>::const_iterator filter_iter = fields.begin();
-    while (p != lim && filter_iter != fields.end()) {
-        assert(p < lim);
-        uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-        p += sizeof(uint32_t);
-        std::string field(p, static_cast<const size_t>(len));
-        p += len;
-        len = *reinterpret_cast<const uint32_t *>(p);
-        p += sizeof(uint32_t);
-        std::string value(p, static_cast<const size_t>(len));
-        p += len;
-        if (*filter_iter == field) {
-            values->push_back({field, value});
-            filter_iter++;
-        }
-    }
-    assert(values->size() == fields.size());
-}
-
-void HashdbDB::DeserializeRow(std::vector<Field> *values,
-                              const std::string &data) {
-    const char *p = data.data();
-    const char *lim = p + data.size();
-    while (p != lim) {
-        assert(p < lim);
-        uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-        p += sizeof(uint32_t);
-        std::string field(p, static_cast<const size_t>(len));
-        p += len;
-        len = *reinterpret_cast<const uint32_t *>(p);
-        p += sizeof(uint32_t);
-        std::string value(p, static_cast<const size_t>(len));
-        p += len;
-        values->push_back({field, value});
-    }
-    assert(values->size() == fieldcount_);
-}
-
 std::string HashdbDB::BuildCompKey(const std::string &key,
                                    const std::string &field_name) {
     switch (format_) {
@@ -356,10 +301,12 @@ DB::Status HashdbDB::ReadSingleEntry(const std::string &table,
         return kNotFound;
     }
 
+    RowReader row(data);
     if (fields != nullptr) {
-        DeserializeRowFilter(&result, data, *fields);
+        row.Decode(*fields, result);
     } else {
-        DeserializeRow(&result, data);
+        row.Decode(result);
+        assert(result.size() == static_cast<size_t>(fieldcount_));
     }
 
     return kOK;
@@ -381,23 +328,9 @@ DB::Status HashdbDB::UpdateSingleEntry(const std::string &table,
         return kNotFound;
     }
 
-    std::vector<Field> current_values;
-    DeserializeRow(&current_values, data);
-    for (Field &new_field : values) {
-        bool found MAYBE_UNUSED = false;
-        for (Field &cur_field : current_values) {
-            if (cur_field.name == new_field.name) {
-                found = true;
-                cur_field.value = new_field.value;
-                break;
-            }
-        }
-        assert(found);
-    }
-
-    data.clear();
-    SerializeRow(current_values, &data);
-    db_->Set(key, data);
+    std::string row;
+    UpdateRow(RowReader(data), values, row);
+    db_->Set(key, std::move(row));
 
     return kOK;
 }
@@ -406,7 +339,7 @@ DB::Status HashdbDB::InsertSingleEntry(const std::string &table,
                                        const std::string &key,
                                        std::vector<Field> &values) {
     std::string data;
-    SerializeRow(values, &data);
+    EncodeRow(values, data);
     db_->Set(key, std::move(data));
     return kOK;
 }
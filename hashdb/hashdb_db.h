@@ -55,11 +55,6 @@ private:
     void SetGflags(const utils::Properties& p);
 
     // void GetOptions(const utils::Properties &props, leveldb::Options *opt);
-    void SerializeRow(const std::vector<Field> &values, std::string *data);
-    void DeserializeRowFilter(std::vector<Field> *values,
-                              const std::string &data,
-                              const std::vector<std::string> &fields);
-    void DeserializeRow(std::vector<Field> *values, const std::string &data);
     std::string BuildCompKey(const std::string &key,
                              const std::string &field_name);
     std::string KeyFromCompKey(const std::string &comp_key);
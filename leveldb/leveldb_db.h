@@ -54,6 +54,20 @@ class LeveldbDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status BatchUpdate(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values) {
+    return (this->*(method_batch_update_))(table, keys, values);
+  }
+
+  Status BatchInsert(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values) {
+    return (this->*(method_batch_insert_))(table, keys, values);
+  }
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
  private:
   enum LdbFormat {
     kSingleEntry,
@@ -63,11 +77,8 @@ class LeveldbDB : public DB {
   LdbFormat format_;
 
   void GetOptions(const utils::Properties &props, leveldb::Options *opt);
-  void SerializeRow(const std::vector<Field> &values, std::string *data);
-  void DeserializeRowFilter(std::vector<Field> *values, const std::string &data,
-                            const std::vector<std::string> &fields);
-  void DeserializeRow(std::vector<Field> *values, const std::string &data);
   std::string BuildCompKey(const std::string &key, const std::string &field_name);
+  size_t CompKeySeparator(const std::string &comp_key);
   std::string KeyFromCompKey(const std::string &comp_key);
   std::string FieldFromCompKey(const std::string &comp_key);
 
@@ -81,6 +92,10 @@ class LeveldbDB : public DB {
   Status InsertSingleEntry(const std::string &table, const std::string &key,
                            std::vector<Field> &values);
   Status DeleteSingleEntry(const std::string &table, const std::string &key);
+  Status BatchUpdateSingleEntry(const std::string &table, const std::vector<std::string> &keys,
+                                std::vector<std::vector<Field>> &values);
+  Status BatchInsertSingleEntry(const std::string &table, const std::vector<std::string> &keys,
+                                std::vector<std::vector<Field>> &values);
 
   Status ReadCompKeyRM(const std::string &table, const std::string &key,
                        const std::vector<std::string> *fields, std::vector<Field> &result);
@@ -95,6 +110,8 @@ class LeveldbDB : public DB {
   Status InsertCompKey(const std::string &table, const std::string &key,
                        std::vector<Field> &values);
   Status DeleteCompKey(const std::string &table, const std::string &key);
+  Status BatchInsertCompKey(const std::string &table, const std::vector<std::string> &keys,
+                            std::vector<std::vector<Field>> &values);
 
   Status (LeveldbDB::*method_read_)(const std::string &, const std:: string &,
                                     const std::vector<std::string> *, std::vector<Field> &);
@@ -106,6 +123,10 @@ class LeveldbDB : public DB {
   Status (LeveldbDB::*method_insert_)(const std::string &, const std::string &,
                                       std::vector<Field> &);
   Status (LeveldbDB::*method_delete_)(const std::string &, const std::string &);
+  Status (LeveldbDB::*method_batch_update_)(const std::string &, const std::vector<std::string> &,
+                                            std::vector<std::vector<Field>> &);
+  Status (LeveldbDB::*method_batch_insert_)(const std::string &, const std::vector<std::string> &,
+                                            std::vector<std::vector<Field>> &);
 
   int fieldcount_;
   std::string field_prefix_;
@@ -16,6 +16,8 @@
 #include "lmdb_db.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/row_codec.h"
+#include "utils/file_clone.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
@@ -42,12 +44,16 @@ namespace {
 
   const std::string PROP_MAPASYNC = "lmdb.mapasync";
   const std::string PROP_MAPASYNC_DEFAULT = "false";
+
+  const std::string PROP_INTEGERKEY = "lmdb.integerkey";
+  const std::string PROP_INTEGERKEY_DEFAULT = "false";
 } // anonymous
 
 namespace ycsbc {
 
 size_t LmdbDB::field_count_;
 std::string LmdbDB::field_prefix_;
+bool LmdbDB::integer_keys_;
 
 MDB_env *LmdbDB::env_;
 MDB_dbi LmdbDB::dbi_;
@@ -68,6 +74,13 @@ void LmdbDB::Init() {
   field_prefix_ = props.GetProperty(CoreWorkload::FIELD_NAME_PREFIX,
                                     CoreWorkload::FIELD_NAME_PREFIX_DEFAULT);
 
+  integer_keys_ = props.GetProperty(PROP_INTEGERKEY, PROP_INTEGERKEY_DEFAULT) == "true";
+  if (integer_keys_ &&
+      (props.GetProperty(CoreWorkload::KEY_FORMAT_PROPERTY, CoreWorkload::KEY_FORMAT_DEFAULT) != "binary" ||
+       props.GetProperty(CoreWorkload::KEY_PREFIX_PROPERTY, CoreWorkload::KEY_PREFIX_DEFAULT) != "")) {
+    throw utils::Exception("LMDB integer keys need keyformat=binary and an empty keyprefix");
+  }
+
   int ret;
   int env_opt = 0;
   if (props.GetProperty(PROP_NOSYNC, PROP_NOSYNC_DEFAULT) == "true") {
@@ -114,7 +127,7 @@ void LmdbDB::Init() {
   if (ret) {
     throw utils::Exception(std::string("Init mdb_txn_begin: ") + mdb_strerror(ret));
   }
-  ret = mdb_open(txn, nullptr, 0, &dbi_);
+  ret = mdb_open(txn, nullptr, integer_keys_ ? MDB_INTEGERKEY : 0, &dbi_);
   if (ret) {
     throw utils::Exception(std::string("Init mdb_open: ") + mdb_strerror(ret));
   }
@@ -133,56 +146,24 @@ void LmdbDB::Cleanup() {
   mdb_env_close(env_);
 }
 
-void LmdbDB::SerializeRow(const std::vector<Field> &values, std::string *data) {
-  for (const Field &field : values) {
-    uint32_t len = field.name.size();
-    data->append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
-    data->append(field.name.data(), field.name.size());
-    len = field.value.size();
-    data->append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
-    data->append(field.value.data(), field.value.size());
-  }
-}
-
-void LmdbDB::DeserializeRowFilter(std::vector<Field> *values, const char *data_ptr, size_t data_len,
-                                  const std::vector<std::string> &fields) {
-  const char *p = data_ptr;
-  const char *lim = p + data_len;
-  std::vector<std::string>::const_iterator filter_iter = fields.begin();
-  while (p != lim && filter_iter != fields.end()) {
-    assert(p < lim);
-    uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string field(p, static_cast<const size_t>(len));
-    p += len;
-    len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string value(p, static_cast<const size_t>(len));
-    p += len;
-    if (*filter_iter == field) {
-      values->push_back({field, value});
-      filter_iter++;
+MDB_val LmdbDB::KeySlice(const std::string &key, uint64_t *buf) {
+  MDB_val slice;
+  if (integer_keys_) {
+    if (key.size() != sizeof(uint64_t)) {
+      throw utils::Exception("LMDB integer keys must be 8 bytes");
+    }
+    uint64_t v = 0;
+    for (unsigned char c : key) {
+      v = v << 8 | c;
     }
+    *buf = v;
+    slice.mv_data = buf;
+    slice.mv_size = sizeof(uint64_t);
+  } else {
+    slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
+    slice.mv_size = key.size();
   }
-  assert(values->size() == fields.size());
-}
-
-void LmdbDB::DeserializeRow(std::vector<Field> *values, const char *data_ptr, size_t data_len) {
-  const char *p = data_ptr;
-  const char *lim = p + data_len;
-  while (p != lim) {
-    assert(p < lim);
-    uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string field(p, static_cast<const size_t>(len));
-    p += len;
-    len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string value(p, static_cast<const size_t>(len));
-    p += len;
-    values->push_back({field, value});
-  }
-  assert(values->size() == field_count_);
+  return slice;
 }
 
 DB::Status LmdbDB::Read(const std::string &table, const std::string &key, const std::vector<std::string> *fields,
@@ -190,9 +171,9 @@ DB::Status LmdbDB::Read(const std::string &table, const std::string &key, const
   DB::Status s = kOK;
   MDB_txn *txn;
   MDB_val key_slice, val_slice;
+  uint64_t key_buf;
 
-  key_slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
-  key_slice.mv_size = key.size();
+  key_slice = KeySlice(key, &key_buf);
 
   int ret;
   ret = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
@@ -207,9 +188,10 @@ DB::Status LmdbDB::Read(const std::string &table, const std::string &key, const
     throw utils::Exception(std::string("Read mdb_get: ") + mdb_strerror(ret));
   }
   if (fields != nullptr) {
-    DeserializeRowFilter(&result, static_cast<char *>(val_slice.mv_data), val_slice.mv_size, *fields);
+    RowReader(static_cast<char *>(val_slice.mv_data), val_slice.mv_size).Decode(*fields, result);
   } else {
-    DeserializeRow(&result, static_cast<char *>(val_slice.mv_data), val_slice.mv_size);
+    RowReader(static_cast<char *>(val_slice.mv_data), val_slice.mv_size).Decode(result);
+    assert(result.size() == field_count_);
   }
 cleanup:
   mdb_txn_abort(txn);
@@ -222,12 +204,12 @@ DB::Status LmdbDB::Scan(const std::string &table, const std::string &key, int le
   MDB_txn *txn;
   MDB_cursor *cursor;
   MDB_val key_slice, val_slice;
+  uint64_t key_buf;
 
-  key_slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
-  key_slice.mv_size = key.size();
+  key_slice = KeySlice(key, &key_buf);
 
   int ret;
-  ret = mdb_txn_begin(env_, nullptr, 0, &txn);
+  ret = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
   if (ret) {
     throw utils::Exception(std::string("Scan mdb_txn_begin: ") + mdb_strerror(ret));
   }
@@ -235,7 +217,8 @@ DB::Status LmdbDB::Scan(const std::string &table, const std::string &key, int le
   if (ret) {
     throw utils::Exception(std::string("Scan mdb_cursor_open: ") + mdb_strerror(ret));
   }
-  ret = mdb_cursor_get(cursor, &key_slice, &val_slice, MDB_SET);
+  // start at the first key not less than the given one, which may be deleted
+  ret = mdb_cursor_get(cursor, &key_slice, &val_slice, MDB_SET_RANGE);
   if (ret == MDB_NOTFOUND) {
     s = kNotFound;
     goto cleanup;
@@ -246,9 +229,10 @@ DB::Status LmdbDB::Scan(const std::string &table, const std::string &key, int le
     result.push_back(std::vector<Field>());
     std::vector<Field> &values = result.back();
     if (fields != nullptr) {
-      DeserializeRowFilter(&values, static_cast<char *>(val_slice.mv_data), val_slice.mv_size, *fields);
+      RowReader(static_cast<char *>(val_slice.mv_data), val_slice.mv_size).Decode(*fields, values);
     } else {
-      DeserializeRow(&values, static_cast<char *>(val_slice.mv_data), val_slice.mv_size);
+      RowReader(static_cast<char *>(val_slice.mv_data), val_slice.mv_size).Decode(values);
+      assert(values.size() == field_count_);
     }
     ret = mdb_cursor_get(cursor, &key_slice, &val_slice, MDB_NEXT);
   }
@@ -261,9 +245,9 @@ cleanup:
 DB::Status LmdbDB::Update(const std::string &table, const std::string &key, std::vector<Field> &values) {
   MDB_txn *txn;
   MDB_val key_slice, val_slice;
+  uint64_t key_buf;
 
-  key_slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
-  key_slice.mv_size = key.size();
+  key_slice = KeySlice(key, &key_buf);
 
   int ret;
   ret = mdb_txn_begin(env_, nullptr, 0, &txn);
@@ -271,25 +255,14 @@ DB::Status LmdbDB::Update(const std::string &table, const std::string &key, std:
     throw utils::Exception(std::string("Update mdb_txn_begin: ") + mdb_strerror(ret));
   }
   ret = mdb_get(txn, dbi_, &key_slice, &val_slice);
-  if (ret) {
+  if (ret == MDB_NOTFOUND) {
+    mdb_txn_abort(txn);
+    return kNotFound;
+  } else if (ret) {
     throw utils::Exception(std::string("Update mdb_get: ") + mdb_strerror(ret));
   }
-  std::vector<Field> current_values;
-  DeserializeRow(&current_values, static_cast<char *>(val_slice.mv_data), val_slice.mv_size);
-  for (Field &new_field : values) {
-    bool found MAYBE_UNUSED = false;
-    for (Field &cur_field : current_values) {
-      if (cur_field.name == new_field.name) {
-        found = true;
-        cur_field.value = new_field.value;
-        break;
-      }
-    }
-    assert(found);
-  }
-
   std::string data;
-  SerializeRow(current_values, &data);
+  UpdateRow(RowReader(static_cast<char *>(val_slice.mv_data), val_slice.mv_size), values, data);
   val_slice.mv_data = const_cast<char *>(data.data());
   val_slice.mv_size = data.size();
   ret = mdb_put(txn, dbi_, &key_slice, &val_slice, 0);
@@ -307,12 +280,12 @@ DB::Status LmdbDB::Update(const std::string &table, const std::string &key, std:
 DB::Status LmdbDB::Insert(const std::string &table, const std::string &key, std::vector<Field> &values) {
   MDB_txn *txn;
   MDB_val key_slice, val_slice;
+  uint64_t key_buf;
 
-  key_slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
-  key_slice.mv_size = key.size();
+  key_slice = KeySlice(key, &key_buf);
 
   std::string data;
-  SerializeRow(values, &data);
+  EncodeRow(values, data);
   val_slice.mv_data = static_cast<void *>(const_cast<char *>(data.data()));
   val_slice.mv_size = data.size();
 
@@ -335,9 +308,9 @@ DB::Status LmdbDB::Insert(const std::string &table, const std::string &key, std:
 DB::Status LmdbDB::Delete(const std::string &table, const std::string &key) {
   MDB_txn *txn;
   MDB_val key_slice;
+  uint64_t key_buf;
 
-  key_slice.mv_data = static_cast<void *>(const_cast<char *>(key.data()));
-  key_slice.mv_size = key.size();
+  key_slice = KeySlice(key, &key_buf);
 
   int ret;
   ret = mdb_txn_begin(env_, nullptr, 0, &txn);
@@ -345,7 +318,10 @@ DB::Status LmdbDB::Delete(const std::string &table, const std::string &key) {
     throw utils::Exception(std::string("Delete mdb_txn_begin: ") + mdb_strerror(ret));
   }
   ret = mdb_del(txn, dbi_, &key_slice, nullptr);
-  if (ret) {
+  if (ret == MDB_NOTFOUND) {
+    mdb_txn_abort(txn);
+    return kNotFound;
+  } else if (ret) {
     throw utils::Exception(std::string("Delete mdb_del: ") + mdb_strerror(ret));
   }
   ret = mdb_txn_commit(txn);
@@ -355,6 +331,167 @@ DB::Status LmdbDB::Delete(const std::string &table, const std::string &key) {
   return kOK;
 }
 
+DB::Status LmdbDB::BatchRead(const std::string &table, const std::vector<std::string> &keys,
+                             const std::vector<std::string> *fields,
+                             std::vector<std::vector<Field>> &result) {
+  DB::Status s = kOK;
+  MDB_txn *txn;
+  MDB_val key_slice, val_slice;
+  uint64_t key_buf;
+
+  int ret;
+  ret = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("BatchRead mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  result.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    key_slice = KeySlice(keys[i], &key_buf);
+    ret = mdb_get(txn, dbi_, &key_slice, &val_slice);
+    if (ret == MDB_NOTFOUND) {
+      s = kNotFound;
+      continue;
+    } else if (ret) {
+      throw utils::Exception(std::string("BatchRead mdb_get: ") + mdb_strerror(ret));
+    }
+    if (fields != nullptr) {
+      RowReader(static_cast<char *>(val_slice.mv_data), val_slice.mv_size).Decode(*fields, result[i]);
+    } else {
+      RowReader(static_cast<char *>(val_slice.mv_data), val_slice.mv_size).Decode(result[i]);
+      assert(result[i].size() == field_count_);
+    }
+  }
+  mdb_txn_abort(txn);
+  return s;
+}
+
+DB::Status LmdbDB::BatchUpdate(const std::string &table, const std::vector<std::string> &keys,
+                               std::vector<std::vector<Field>> &values) {
+  DB::Status s = kOK;
+  MDB_txn *txn;
+  MDB_val key_slice, val_slice;
+  uint64_t key_buf;
+
+  int ret;
+  ret = mdb_txn_begin(env_, nullptr, 0, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("BatchUpdate mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  std::string data;
+  for (size_t i = 0; i < keys.size(); i++) {
+    key_slice = KeySlice(keys[i], &key_buf);
+    ret = mdb_get(txn, dbi_, &key_slice, &val_slice);
+    if (ret == MDB_NOTFOUND) {
+      s = kNotFound;
+      continue;
+    } else if (ret) {
+      throw utils::Exception(std::string("BatchUpdate mdb_get: ") + mdb_strerror(ret));
+    }
+    data.clear();
+    UpdateRow(RowReader(static_cast<char *>(val_slice.mv_data), val_slice.mv_size), values[i], data);
+    val_slice.mv_data = const_cast<char *>(data.data());
+    val_slice.mv_size = data.size();
+    ret = mdb_put(txn, dbi_, &key_slice, &val_slice, 0);
+    if (ret) {
+      throw utils::Exception(std::string("BatchUpdate mdb_put: ") + mdb_strerror(ret));
+    }
+  }
+
+  ret = mdb_txn_commit(txn);
+  if (ret) {
+    throw utils::Exception(std::string("BatchUpdate mdb_txn_commit: ") + mdb_strerror(ret));
+  }
+  return s;
+}
+
+DB::Status LmdbDB::BatchInsert(const std::string &table, const std::vector<std::string> &keys,
+                               std::vector<std::vector<Field>> &values) {
+  MDB_txn *txn;
+  MDB_val key_slice, val_slice;
+  uint64_t key_buf;
+
+  int ret;
+  ret = mdb_txn_begin(env_, nullptr, 0, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("BatchInsert mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  std::string data;
+  for (size_t i = 0; i < keys.size(); i++) {
+    key_slice = KeySlice(keys[i], &key_buf);
+
+    data.clear();
+    EncodeRow(values[i], data);
+    val_slice.mv_data = static_cast<void *>(const_cast<char *>(data.data()));
+    val_slice.mv_size = data.size();
+    ret = mdb_put(txn, dbi_, &key_slice, &val_slice, 0);
+    if (ret) {
+      throw utils::Exception(std::string("BatchInsert mdb_put: ") + mdb_strerror(ret));
+    }
+  }
+  ret = mdb_txn_commit(txn);
+  if (ret) {
+    throw utils::Exception(std::string("BatchInsert mdb_txn_commit: ") + mdb_strerror(ret));
+  }
+  return kOK;
+}
+
+DB::Status LmdbDB::BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                              std::vector<std::vector<Field>> &values) {
+  MDB_txn *txn;
+  MDB_val key_slice, val_slice;
+  uint64_t key_buf;
+
+  int ret;
+  ret = mdb_txn_begin(env_, nullptr, 0, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("BulkInsert mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  std::string data;
+  for (size_t i = 0; i < keys.size(); i++) {
+    key_slice = KeySlice(keys[i], &key_buf);
+
+    data.clear();
+    EncodeRow(values[i], data);
+    val_slice.mv_data = static_cast<void *>(const_cast<char *>(data.data()));
+    val_slice.mv_size = data.size();
+    // appending requires the key to sort after every key in the DB, which
+    // does not hold once another loader has written a later range
+    ret = mdb_put(txn, dbi_, &key_slice, &val_slice, MDB_APPEND);
+    if (ret == MDB_KEYEXIST) {
+      ret = mdb_put(txn, dbi_, &key_slice, &val_slice, 0);
+    }
+    if (ret) {
+      throw utils::Exception(std::string("BulkInsert mdb_put: ") + mdb_strerror(ret));
+    }
+  }
+  ret = mdb_txn_commit(txn);
+  if (ret) {
+    throw utils::Exception(std::string("BulkInsert mdb_txn_commit: ") + mdb_strerror(ret));
+  }
+  return kOK;
+}
+
+DB::Status LmdbDB::Snapshot(const std::string &dir) {
+  int ret = mkdir(dir.c_str(), 0775);
+  if (ret) {
+    throw utils::Exception(std::string("Snapshot mkdir: ") + strerror(errno));
+  }
+  ret = mdb_env_copy2(env_, dir.c_str(), MDB_CP_COMPACT);
+  if (ret) {
+    throw utils::Exception(std::string("Snapshot mdb_env_copy2: ") + mdb_strerror(ret));
+  }
+  return kOK;
+}
+
+DB::Status LmdbDB::Restore(const std::string &dir) {
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("LMDB db path is missing");
+  }
+  utils::RestoreDirectory(dir, db_path);
+  return kOK;
+}
+
 DB *NewLmdbDB() {
   return new LmdbDB;
 }
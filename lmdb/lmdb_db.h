@@ -38,14 +38,33 @@ class LmdbDB : public DB {
 
   Status Delete(const std::string &table, const std::string &key);
 
+  Status BatchRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields,
+                   std::vector<std::vector<Field>> &result);
+
+  Status BatchUpdate(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values);
+
+  Status BatchInsert(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values);
+
+  Status BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                    std::vector<std::vector<Field>> &values);
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
  private:
-  void SerializeRow(const std::vector<Field> &values, std::string *data);
-  void DeserializeRowFilter(std::vector<Field> *values, const char *data_ptr, size_t data_len,
-                            const std::vector<std::string> &fields);
-  void DeserializeRow(std::vector<Field> *values, const char *data_ptr, size_t data_len);
+  ///
+  /// Returns the LMDB key of key. With integer keys, that is the 8-byte
+  /// big-endian key converted to a native integer kept in *buf.
+  ///
+  static MDB_val KeySlice(const std::string &key, uint64_t *buf);
 
   static size_t field_count_;
   static std::string field_prefix_;
+  static bool integer_keys_;
 
   static MDB_env *env_;
   static MDB_dbi dbi_;
@@ -9,6 +9,8 @@
 #include "pebblesdb_db.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/row_codec.h"
+#include "utils/file_clone.h"
 #include "utils/utils.h"
 
 #include <pebblesdb/options.h>
@@ -67,6 +69,8 @@ void PebblesdbDB::Init() {
     method_update_ = &PebblesdbDB::UpdateSingleEntry;
     method_insert_ = &PebblesdbDB::InsertSingleEntry;
     method_delete_ = &PebblesdbDB::DeleteSingleEntry;
+    method_batch_update_ = &PebblesdbDB::BatchUpdateSingleEntry;
+    method_batch_insert_ = &PebblesdbDB::BatchInsertSingleEntry;
   } else if (format == "row") {
     format_ = kRowMajor;
     method_read_ = &PebblesdbDB::ReadCompKeyRM;
@@ -74,6 +78,8 @@ void PebblesdbDB::Init() {
     method_update_ = &PebblesdbDB::InsertCompKey;
     method_insert_ = &PebblesdbDB::InsertCompKey;
     method_delete_ = &PebblesdbDB::DeleteCompKey;
+    method_batch_update_ = &PebblesdbDB::BatchInsertCompKey;
+    method_batch_insert_ = &PebblesdbDB::BatchInsertCompKey;
   } else if (format == "column") {
     format_ = kColumnMajor;
     method_read_ = &PebblesdbDB::ReadCompKeyCM;
@@ -81,6 +87,8 @@ void PebblesdbDB::Init() {
     method_update_ = &PebblesdbDB::InsertCompKey;
     method_insert_ = &PebblesdbDB::InsertCompKey;
     method_delete_ = &PebblesdbDB::DeleteCompKey;
+    method_batch_update_ = &PebblesdbDB::BatchInsertCompKey;
+    method_batch_insert_ = &PebblesdbDB::BatchInsertCompKey;
   } else {
     throw utils::Exception("unknown format");
   }
@@ -125,6 +133,35 @@ void PebblesdbDB::Cleanup() {
   delete db_;
 }
 
+DB::Status PebblesdbDB::Snapshot(const std::string &dir) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  const std::string &db_path = props_->GetProperty(PROP_NAME, PROP_NAME_DEFAULT);
+
+  // there is no checkpoint API, so close the DB to quiesce compactions and clone its files
+  delete db_;
+  db_ = nullptr;
+  utils::CloneDirectory(db_path, dir, utils::IsTableFile);
+
+  leveldb::Options opt;
+  GetOptions(*props_, &opt);
+  leveldb::Status s = leveldb::DB::Open(opt, db_path, &db_);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("LevelDB Open: ") + s.ToString());
+  }
+  return kOK;
+}
+
+DB::Status PebblesdbDB::Restore(const std::string &dir) {
+  const std::string &db_path = props_->GetProperty(PROP_NAME, PROP_NAME_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("LevelDB db path is missing");
+  }
+  utils::RestoreDirectory(dir, db_path, utils::IsTableFile);
+  // keep the restored files when the DB is opened
+  props_->SetProperty(PROP_DESTROY, "false");
+  return kOK;
+}
+
 void PebblesdbDB::GetOptions(const utils::Properties &props, leveldb::Options *opt) {
   size_t writer_buffer_size = std::stol(props.GetProperty(PROP_WRITE_BUFFER_SIZE,
                                                           PROP_WRITE_BUFFER_SIZE_DEFAULT));
@@ -170,59 +207,6 @@ void PebblesdbDB::GetOptions(const utils::Properties &props, leveldb::Options *o
   }
 }
 
-void PebblesdbDB::SerializeRow(const std::vector<Field> &values, std::string *data) {
-  for (const Field &field : values) {
-    uint32_t len = field.name.size();
-    data->append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
-    data->append(field.name.data(), field.name.size());
-    len = field.value.size();
-    data->append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
-    data->append(field.value.data(), field.value.size());
-  }
-}
-
-void PebblesdbDB::DeserializeRowFilter(std::vector<Field> *values, const std::string &data,
-                                     const std::vector<std::string> &fields) {
-  const char *p = data.data();
-  const char *lim = p + data.size();
-
-  std::vector<std::string>::const_iterator filter_iter = fields.begin();
-  while (p != lim && filter_iter != fields.end()) {
-    assert(p < lim);
-    uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string field(p, static_cast<const size_t>(len));
-    p += len;
-    len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string value(p, static_cast<const size_t>(len));
-    p += len;
-    if (*filter_iter == field) {
-      values->push_back({field, value});
-      filter_iter++;
-    }
-  }
-  assert(values->size() == fields.size());
-}
-
-void PebblesdbDB::DeserializeRow(std::vector<Field> *values, const std::string &data) {
-  const char *p = data.data();
-  const char *lim = p + data.size();
-  while (p != lim) {
-    assert(p < lim);
-    uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string field(p, static_cast<const size_t>(len));
-    p += len;
-    len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string value(p, static_cast<const size_t>(len));
-    p += len;
-    values->push_back({field, value});
-  }
-  assert(values->size() == fieldcount_);
-}
-
 std::string PebblesdbDB::BuildCompKey(const std::string &key, const std::string &field_name) {
   switch (format_) {
     case kRowMajor:
@@ -236,16 +220,22 @@ std::string PebblesdbDB::BuildCompKey(const std::string &key, const std::string
   }
 }
 
+// Keys may be binary and contain ':', field names do not, so the separator
+// is the last ':' of a row-major key and the first of a column-major one.
+size_t PebblesdbDB::CompKeySeparator(const std::string &comp_key) {
+  return format_ == kColumnMajor ? comp_key.find(':') : comp_key.rfind(':');
+}
+
 std::string PebblesdbDB::KeyFromCompKey(const std::string &comp_key) {
-  size_t idx = comp_key.find(":");
+  size_t idx = CompKeySeparator(comp_key);
   assert(idx != std::string::npos);
-  return comp_key.substr(0, idx);
+  return format_ == kColumnMajor ? comp_key.substr(idx + 1) : comp_key.substr(0, idx);
 }
 
 std::string PebblesdbDB::FieldFromCompKey(const std::string &comp_key) {
-  size_t idx = comp_key.find(":");
+  size_t idx = CompKeySeparator(comp_key);
   assert(idx != std::string::npos);
-  return comp_key.substr(idx + 1);
+  return format_ == kColumnMajor ? comp_key.substr(0, idx) : comp_key.substr(idx + 1);
 }
 
 DB::Status PebblesdbDB::ReadSingleEntry(const std::string &table, const std::string &key,
@@ -258,10 +248,12 @@ DB::Status PebblesdbDB::ReadSingleEntry(const std::string &table, const std::str
   } else if (!s.ok()) {
     throw utils::Exception(std::string("LevelDB Get: ") + s.ToString());
   }
+  RowReader row(data);
   if (fields != nullptr) {
-    DeserializeRowFilter(&result, data, *fields);
+    row.Decode(*fields, result);
   } else {
-    DeserializeRow(&result, data);
+    row.Decode(result);
+    assert(result.size() == static_cast<size_t>(fieldcount_));
   }
   return kOK;
 }
@@ -272,13 +264,14 @@ DB::Status PebblesdbDB::ScanSingleEntry(const std::string &table, const std::str
   leveldb::Iterator *db_iter = db_->NewIterator(leveldb::ReadOptions());
   db_iter->Seek(key);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
-    std::string data = db_iter->value().ToString();
+    RowReader row(db_iter->value().data(), db_iter->value().size());
     result.push_back(std::vector<Field>());
     std::vector<Field> &values = result.back();
     if (fields != nullptr) {
-      DeserializeRowFilter(&values, data, *fields);
+      row.Decode(*fields, values);
     } else {
-      DeserializeRow(&values, data);
+      row.Decode(values);
+      assert(values.size() == static_cast<size_t>(fieldcount_));
     }
     db_iter->Next();
   }
@@ -295,24 +288,10 @@ DB::Status PebblesdbDB::UpdateSingleEntry(const std::string &table, const std::s
   } else if (!s.ok()) {
     throw utils::Exception(std::string("LevelDB Get: ") + s.ToString());
   }
-  std::vector<Field> current_values;
-  DeserializeRow(&current_values, data);
-  for (Field &new_field : values) {
-    bool found MAYBE_UNUSED = false;
-    for (Field &cur_field : current_values) {
-      if (cur_field.name == new_field.name) {
-        found = true;
-        cur_field.value = new_field.value;
-        break;
-      }
-    }
-    assert(found);
-  }
+  std::string row;
+  UpdateRow(RowReader(data), values, row);
   leveldb::WriteOptions wopt;
-
-  data.clear();
-  SerializeRow(current_values, &data);
-  s = db_->Put(wopt, key, data);
+  s = db_->Put(wopt, key, row);
   if (!s.ok()) {
     throw utils::Exception(std::string("LevelDB Put: ") + s.ToString());
   }
@@ -322,7 +301,7 @@ DB::Status PebblesdbDB::UpdateSingleEntry(const std::string &table, const std::s
 DB::Status PebblesdbDB::InsertSingleEntry(const std::string &table, const std::string &key,
                                         std::vector<Field> &values) {
   std::string data;
-  SerializeRow(values, &data);
+  EncodeRow(values, data);
   leveldb::WriteOptions wopt;
   leveldb::Status s = db_->Put(wopt, key, data);
   if (!s.ok()) {
@@ -340,6 +319,51 @@ DB::Status PebblesdbDB::DeleteSingleEntry(const std::string &table, const std::s
   return kOK;
 }
 
+DB::Status PebblesdbDB::BatchUpdateSingleEntry(const std::string &table,
+                                               const std::vector<std::string> &keys,
+                                               std::vector<std::vector<Field>> &values) {
+  Status status = kOK;
+  leveldb::WriteBatch batch;
+  std::string data;
+  std::string row;
+  for (size_t i = 0; i < keys.size(); i++) {
+    leveldb::Status s = db_->Get(leveldb::ReadOptions(), keys[i], &data);
+    if (s.IsNotFound()) {
+      status = kNotFound;
+      continue;
+    } else if (!s.ok()) {
+      throw utils::Exception(std::string("LevelDB Get: ") + s.ToString());
+    }
+    row.clear();
+    UpdateRow(RowReader(data), values[i], row);
+    batch.Put(keys[i], row);
+  }
+  leveldb::WriteOptions wopt;
+  leveldb::Status s = db_->Write(wopt, &batch);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("LevelDB Write: ") + s.ToString());
+  }
+  return status;
+}
+
+DB::Status PebblesdbDB::BatchInsertSingleEntry(const std::string &table,
+                                               const std::vector<std::string> &keys,
+                                               std::vector<std::vector<Field>> &values) {
+  leveldb::WriteBatch batch;
+  std::string data;
+  for (size_t i = 0; i < keys.size(); i++) {
+    data.clear();
+    EncodeRow(values[i], data);
+    batch.Put(keys[i], data);
+  }
+  leveldb::WriteOptions wopt;
+  leveldb::Status s = db_->Write(wopt, &batch);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("LevelDB Write: ") + s.ToString());
+  }
+  return kOK;
+}
+
 DB::Status PebblesdbDB::ReadCompKeyRM(const std::string &table, const std::string &key,
                                     const std::vector<std::string> *fields,
                                     std::vector<Field> &result) {
@@ -456,6 +480,27 @@ DB::Status PebblesdbDB::InsertCompKey(const std::string &table, const std::strin
   return kOK;
 }
 
+DB::Status PebblesdbDB::BatchInsertCompKey(const std::string &table,
+                                           const std::vector<std::string> &keys,
+                                           std::vector<std::vector<Field>> &values) {
+  leveldb::WriteOptions wopt;
+  leveldb::WriteBatch batch;
+
+  std::string comp_key;
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (Field &field : values[i]) {
+      comp_key = BuildCompKey(keys[i], field.name);
+      batch.Put(comp_key, field.value);
+    }
+  }
+
+  leveldb::Status s = db_->Write(wopt, &batch);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("LevelDB Write: ") + s.ToString());
+  }
+  return kOK;
+}
+
 DB::Status PebblesdbDB::DeleteCompKey(const std::string &table, const std::string &key) {
   leveldb::WriteOptions wopt;
   leveldb::WriteBatch batch;
@@ -10,12 +10,17 @@
 
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/row_codec.h"
+#include "utils/file_clone.h"
 #include "utils/utils.h"
 
 #include <rocksdb/cache.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/merge_operator.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/sst_file_writer.h>
 #include <rocksdb/status.h>
+#include <rocksdb/utilities/checkpoint.h>
 #include <rocksdb/utilities/options_util.h>
 #include <rocksdb/write_batch.h>
 
@@ -89,6 +94,9 @@ namespace {
   const std::string PROP_BLOOM_BITS = "rocksdb.bloom_bits";
   const std::string PROP_BLOOM_BITS_DEFAULT = "0";
 
+  const std::string PROP_PREFIX_LENGTH = "rocksdb.prefix_length";
+  const std::string PROP_PREFIX_LENGTH_DEFAULT = "0";
+
   const std::string PROP_INCREASE_PARALLELISM = "rocksdb.increase_parallelism";
   const std::string PROP_INCREASE_PARALLELISM_DEFAULT = "false";
 
@@ -117,6 +125,7 @@ std::vector<rocksdb::ColumnFamilyHandle *> RocksdbDB::cf_handles_;
 rocksdb::DB *RocksdbDB::db_ = nullptr;
 int RocksdbDB::ref_cnt_ = 0;
 std::mutex RocksdbDB::mu_;
+std::atomic<uint64_t> RocksdbDB::sst_seq_{0};
 
 void RocksdbDB::Init() {
 // merge operator disabled by default due to link error
@@ -128,31 +137,9 @@ void RocksdbDB::Init() {
                        rocksdb::Logger *logger) const override {
       assert(existing_value);
 
-      std::vector<Field> values;
-      const char *p = existing_value->data();
-      const char *lim = p + existing_value->size();
-      DeserializeRow(values, p, lim);
-
-      std::vector<Field> new_values;
-      p = value.data();
-      lim = p + value.size();
-      DeserializeRow(new_values, p, lim);
-
-      for (Field &new_field : new_values) {
-        bool found = false;
-        for (Field &field : values) {
-          if (field.name == new_field.name) {
-            found = true;
-            field.value = new_field.value;
-            break;
-          }
-        }
-        if (!found) {
-          values.push_back(new_field);
-        }
-      }
-
-      SerializeRow(values, *new_value);
+      new_value->clear();
+      UpdateRow(RowReader(existing_value->data(), existing_value->size()),
+                RowReader(value.data(), value.size()), *new_value);
       return true;
     }
 
@@ -172,9 +159,14 @@ void RocksdbDB::Init() {
     method_update_ = &RocksdbDB::UpdateSingle;
     method_insert_ = &RocksdbDB::InsertSingle;
     method_delete_ = &RocksdbDB::DeleteSingle;
+    method_batch_read_ = &RocksdbDB::BatchReadSingle;
+    method_batch_update_ = &RocksdbDB::BatchUpdateSingle;
+    method_batch_insert_ = &RocksdbDB::BatchInsertSingle;
+    method_bulk_insert_ = &RocksdbDB::BulkInsertSingle;
 #ifdef USE_MERGEUPDATE
     if (props.GetProperty(PROP_MERGEUPDATE, PROP_MERGEUPDATE_DEFAULT) == "true") {
       method_update_ = &RocksdbDB::MergeSingle;
+      method_batch_update_ = &RocksdbDB::BatchMergeSingle;
     }
 #endif
   } else {
@@ -358,6 +350,12 @@ void RocksdbDB::GetOptions(const utils::Properties &props, rocksdb::Options *opt
     }
     opt->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
 
+    // filters then cover the first prefix_length bytes of the keys as well
+    size_t prefix_length = std::stoul(props.GetProperty(PROP_PREFIX_LENGTH, PROP_PREFIX_LENGTH_DEFAULT));
+    if (prefix_length > 0) {
+      opt->prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(prefix_length));
+    }
+
     if (props.GetProperty(PROP_INCREASE_PARALLELISM, PROP_INCREASE_PARALLELISM_DEFAULT) == "true") {
       opt->IncreaseParallelism();
     }
@@ -367,66 +365,6 @@ void RocksdbDB::GetOptions(const utils::Properties &props, rocksdb::Options *opt
   }
 }
 
-void RocksdbDB::SerializeRow(const std::vector<Field> &values, std::string &data) {
-  for (const Field &field : values) {
-    uint32_t len = field.name.size();
-    data.append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
-    data.append(field.name.data(), field.name.size());
-    len = field.value.size();
-    data.append(reinterpret_cast<char *>(&len), sizeof(uint32_t));
-    data.append(field.value.data(), field.value.size());
-  }
-}
-
-void RocksdbDB::DeserializeRowFilter(std::vector<Field> &values, const char *p, const char *lim,
-                                     const std::vector<std::string> &fields) {
-  std::vector<std::string>::const_iterator filter_iter = fields.begin();
-  while (p != lim && filter_iter != fields.end()) {
-    assert(p < lim);
-    uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string field(p, static_cast<const size_t>(len));
-    p += len;
-    len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string value(p, static_cast<const size_t>(len));
-    p += len;
-    if (*filter_iter == field) {
-      values.push_back({field, value});
-      filter_iter++;
-    }
-  }
-  assert(values.size() == fields.size());
-}
-
-void RocksdbDB::DeserializeRowFilter(std::vector<Field> &values, const std::string &data,
-                                     const std::vector<std::string> &fields) {
-  const char *p = data.data();
-  const char *lim = p + data.size();
-  DeserializeRowFilter(values, p, lim, fields);
-}
-
-void RocksdbDB::DeserializeRow(std::vector<Field> &values, const char *p, const char *lim) {
-  while (p != lim) {
-    assert(p < lim);
-    uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string field(p, static_cast<const size_t>(len));
-    p += len;
-    len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string value(p, static_cast<const size_t>(len));
-    p += len;
-    values.push_back({field, value});
-  }
-}
-
-void RocksdbDB::DeserializeRow(std::vector<Field> &values, const std::string &data) {
-  const char *p = data.data();
-  const char *lim = p + data.size();
-  DeserializeRow(values, p, lim);
-}
-
 DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &key,
                                  const std::vector<std::string> *fields,
                                  std::vector<Field> &result) {
@@ -437,10 +375,11 @@ DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &ke
   } else if (!s.ok()) {
     throw utils::Exception(std::string("RocksDB Get: ") + s.ToString());
   }
+  RowReader row(data);
   if (fields != nullptr) {
-    DeserializeRowFilter(result, data, *fields);
+    row.Decode(*fields, result);
   } else {
-    DeserializeRow(result, data);
+    row.Decode(result);
     assert(result.size() == static_cast<size_t>(fieldcount_));
   }
   return kOK;
@@ -449,16 +388,19 @@ DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &ke
 DB::Status RocksdbDB::ScanSingle(const std::string &table, const std::string &key, int len,
                                  const std::vector<std::string> *fields,
                                  std::vector<std::vector<Field>> &result) {
-  rocksdb::Iterator *db_iter = db_->NewIterator(rocksdb::ReadOptions());
+  // scans run past the prefix of their first key
+  rocksdb::ReadOptions read_options;
+  read_options.total_order_seek = true;
+  rocksdb::Iterator *db_iter = db_->NewIterator(read_options);
   db_iter->Seek(key);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
-    std::string data = db_iter->value().ToString();
+    RowReader row(db_iter->value().data(), db_iter->value().size());
     result.push_back(std::vector<Field>());
     std::vector<Field> &values = result.back();
     if (fields != nullptr) {
-      DeserializeRowFilter(values, data, *fields);
+      row.Decode(*fields, values);
     } else {
-      DeserializeRow(values, data);
+      row.Decode(values);
       assert(values.size() == static_cast<size_t>(fieldcount_));
     }
     db_iter->Next();
@@ -476,25 +418,10 @@ DB::Status RocksdbDB::UpdateSingle(const std::string &table, const std::string &
   } else if (!s.ok()) {
     throw utils::Exception(std::string("RocksDB Get: ") + s.ToString());
   }
-  std::vector<Field> current_values;
-  DeserializeRow(current_values, data);
-  assert(current_values.size() == static_cast<size_t>(fieldcount_));
-  for (Field &new_field : values) {
-    bool found MAYBE_UNUSED = false;
-    for (Field &cur_field : current_values) {
-      if (cur_field.name == new_field.name) {
-        found = true;
-        cur_field.value = new_field.value;
-        break;
-      }
-    }
-    assert(found);
-  }
+  std::string row;
+  UpdateRow(RowReader(data), values, row);
   rocksdb::WriteOptions wopt;
-
-  data.clear();
-  SerializeRow(current_values, data);
-  s = db_->Put(wopt, key, data);
+  s = db_->Put(wopt, key, row);
   if (!s.ok()) {
     throw utils::Exception(std::string("RocksDB Put: ") + s.ToString());
   }
@@ -504,7 +431,7 @@ DB::Status RocksdbDB::UpdateSingle(const std::string &table, const std::string &
 DB::Status RocksdbDB::MergeSingle(const std::string &table, const std::string &key,
                                   std::vector<Field> &values) {
   std::string data;
-  SerializeRow(values, data);
+  EncodeRow(values, data);
   rocksdb::WriteOptions wopt;
   rocksdb::Status s = db_->Merge(wopt, key, data);
   if (!s.ok()) {
@@ -516,7 +443,7 @@ DB::Status RocksdbDB::MergeSingle(const std::string &table, const std::string &k
 DB::Status RocksdbDB::InsertSingle(const std::string &table, const std::string &key,
                                    std::vector<Field> &values) {
   std::string data;
-  SerializeRow(values, data);
+  EncodeRow(values, data);
   rocksdb::WriteOptions wopt;
   rocksdb::Status s = db_->Put(wopt, key, data);
   if (!s.ok()) {
@@ -534,6 +461,157 @@ DB::Status RocksdbDB::DeleteSingle(const std::string &table, const std::string &
   return kOK;
 }
 
+DB::Status RocksdbDB::BatchReadSingle(const std::string &table,
+                                      const std::vector<std::string> &keys,
+                                      const std::vector<std::string> *fields,
+                                      std::vector<std::vector<Field>> &result) {
+  std::vector<rocksdb::Slice> key_slices(keys.begin(), keys.end());
+  std::vector<std::string> data;
+  std::vector<rocksdb::Status> ss = db_->MultiGet(rocksdb::ReadOptions(), key_slices, &data);
+  Status status = kOK;
+  result.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (ss[i].IsNotFound()) {
+      status = kNotFound;
+      continue;
+    } else if (!ss[i].ok()) {
+      throw utils::Exception(std::string("RocksDB MultiGet: ") + ss[i].ToString());
+    }
+    RowReader row(data[i]);
+    if (fields != nullptr) {
+      row.Decode(*fields, result[i]);
+    } else {
+      row.Decode(result[i]);
+      assert(result[i].size() == static_cast<size_t>(fieldcount_));
+    }
+  }
+  return status;
+}
+
+DB::Status RocksdbDB::BatchUpdateSingle(const std::string &table,
+                                        const std::vector<std::string> &keys,
+                                        std::vector<std::vector<Field>> &values) {
+  std::vector<rocksdb::Slice> key_slices(keys.begin(), keys.end());
+  std::vector<std::string> data;
+  std::vector<rocksdb::Status> ss = db_->MultiGet(rocksdb::ReadOptions(), key_slices, &data);
+  Status status = kOK;
+  rocksdb::WriteBatch batch;
+  std::string row;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (ss[i].IsNotFound()) {
+      status = kNotFound;
+      continue;
+    } else if (!ss[i].ok()) {
+      throw utils::Exception(std::string("RocksDB MultiGet: ") + ss[i].ToString());
+    }
+    row.clear();
+    UpdateRow(RowReader(data[i]), values[i], row);
+    batch.Put(keys[i], row);
+  }
+  rocksdb::WriteOptions wopt;
+  rocksdb::Status s = db_->Write(wopt, &batch);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Write: ") + s.ToString());
+  }
+  return status;
+}
+
+DB::Status RocksdbDB::BatchMergeSingle(const std::string &table,
+                                       const std::vector<std::string> &keys,
+                                       std::vector<std::vector<Field>> &values) {
+  rocksdb::WriteBatch batch;
+  std::string data;
+  for (size_t i = 0; i < keys.size(); i++) {
+    data.clear();
+    EncodeRow(values[i], data);
+    batch.Merge(keys[i], data);
+  }
+  rocksdb::WriteOptions wopt;
+  rocksdb::Status s = db_->Write(wopt, &batch);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Write: ") + s.ToString());
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::BatchInsertSingle(const std::string &table,
+                                        const std::vector<std::string> &keys,
+                                        std::vector<std::vector<Field>> &values) {
+  rocksdb::WriteBatch batch;
+  std::string data;
+  for (size_t i = 0; i < keys.size(); i++) {
+    data.clear();
+    EncodeRow(values[i], data);
+    batch.Put(keys[i], data);
+  }
+  rocksdb::WriteOptions wopt;
+  rocksdb::Status s = db_->Write(wopt, &batch);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Write: ") + s.ToString());
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::BulkInsertSingle(const std::string &table,
+                                       const std::vector<std::string> &keys,
+                                       std::vector<std::vector<Field>> &values) {
+  if (keys.empty()) {
+    return kOK;
+  }
+  // write the sorted records into an SST file next to the DB and move it in
+  const std::string sst_path = db_->GetName() + "/ycsb-bulk-" + std::to_string(sst_seq_++) + ".sst";
+  rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), db_->GetOptions());
+  rocksdb::Status s = writer.Open(sst_path);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB SstFileWriter Open: ") + s.ToString());
+  }
+  std::string data;
+  for (size_t i = 0; i < keys.size(); i++) {
+    data.clear();
+    EncodeRow(values[i], data);
+    s = writer.Put(keys[i], data);
+    if (!s.ok()) {
+      throw utils::Exception(std::string("RocksDB SstFileWriter Put: ") + s.ToString());
+    }
+  }
+  s = writer.Finish();
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB SstFileWriter Finish: ") + s.ToString());
+  }
+  rocksdb::IngestExternalFileOptions iopt;
+  iopt.move_files = true;
+  s = db_->IngestExternalFile({sst_path}, iopt);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB IngestExternalFile: ") + s.ToString());
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::Snapshot(const std::string &dir) {
+  rocksdb::Checkpoint *checkpoint;
+  rocksdb::Status s = rocksdb::Checkpoint::Create(db_, &checkpoint);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Checkpoint: ") + s.ToString());
+  }
+  s = checkpoint->CreateCheckpoint(dir);
+  delete checkpoint;
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB CreateCheckpoint: ") + s.ToString());
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::Restore(const std::string &dir) {
+  const std::string &db_path = props_->GetProperty(PROP_NAME, PROP_NAME_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("RocksDB db path is missing");
+  }
+  utils::RestoreDirectory(dir, db_path, utils::IsTableFile);
+  // keep the restored files when the DB is opened
+  props_->SetProperty(PROP_DESTROY, "false");
+  return kOK;
+}
+
 DB *NewRocksdbDB() {
   return new RocksdbDB;
 }
@@ -8,6 +8,7 @@
 #ifndef YCSB_C_ROCKSDB_DB_H_
 #define YCSB_C_ROCKSDB_DB_H_
 
+#include <atomic>
 #include <string>
 #include <mutex>
 
@@ -50,6 +51,31 @@ class RocksdbDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status BatchRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields,
+                   std::vector<std::vector<Field>> &result) {
+    return (this->*(method_batch_read_))(table, keys, fields, result);
+  }
+
+  Status BatchUpdate(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values) {
+    return (this->*(method_batch_update_))(table, keys, values);
+  }
+
+  Status BatchInsert(const std::string &table, const std::vector<std::string> &keys,
+                     std::vector<std::vector<Field>> &values) {
+    return (this->*(method_batch_insert_))(table, keys, values);
+  }
+
+  Status BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                    std::vector<std::vector<Field>> &values) {
+    return (this->*(method_bulk_insert_))(table, keys, values);
+  }
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
  private:
   enum RocksFormat {
     kSingleRow,
@@ -58,13 +84,6 @@ class RocksdbDB : public DB {
 
   void GetOptions(const utils::Properties &props, rocksdb::Options *opt,
                   std::vector<rocksdb::ColumnFamilyDescriptor> *cf_descs);
-  static void SerializeRow(const std::vector<Field> &values, std::string &data);
-  static void DeserializeRowFilter(std::vector<Field> &values, const char *p, const char *lim,
-                                   const std::vector<std::string> &fields);
-  static void DeserializeRowFilter(std::vector<Field> &values, const std::string &data,
-                                   const std::vector<std::string> &fields);
-  static void DeserializeRow(std::vector<Field> &values, const char *p, const char *lim);
-  static void DeserializeRow(std::vector<Field> &values, const std::string &data);
 
   Status ReadSingle(const std::string &table, const std::string &key,
                     const std::vector<std::string> *fields, std::vector<Field> &result);
@@ -78,6 +97,17 @@ class RocksdbDB : public DB {
   Status InsertSingle(const std::string &table, const std::string &key,
                       std::vector<Field> &values);
   Status DeleteSingle(const std::string &table, const std::string &key);
+  Status BatchReadSingle(const std::string &table, const std::vector<std::string> &keys,
+                         const std::vector<std::string> *fields,
+                         std::vector<std::vector<Field>> &result);
+  Status BatchUpdateSingle(const std::string &table, const std::vector<std::string> &keys,
+                           std::vector<std::vector<Field>> &values);
+  Status BatchMergeSingle(const std::string &table, const std::vector<std::string> &keys,
+                          std::vector<std::vector<Field>> &values);
+  Status BatchInsertSingle(const std::string &table, const std::vector<std::string> &keys,
+                           std::vector<std::vector<Field>> &values);
+  Status BulkInsertSingle(const std::string &table, const std::vector<std::string> &keys,
+                          std::vector<std::vector<Field>> &values);
 
   Status (RocksdbDB::*method_read_)(const std::string &, const std:: string &,
                                     const std::vector<std::string> *, std::vector<Field> &);
@@ -89,6 +119,15 @@ class RocksdbDB : public DB {
   Status (RocksdbDB::*method_insert_)(const std::string &, const std::string &,
                                       std::vector<Field> &);
   Status (RocksdbDB::*method_delete_)(const std::string &, const std::string &);
+  Status (RocksdbDB::*method_batch_read_)(const std::string &, const std::vector<std::string> &,
+                                          const std::vector<std::string> *,
+                                          std::vector<std::vector<Field>> &);
+  Status (RocksdbDB::*method_batch_update_)(const std::string &, const std::vector<std::string> &,
+                                            std::vector<std::vector<Field>> &);
+  Status (RocksdbDB::*method_batch_insert_)(const std::string &, const std::vector<std::string> &,
+                                            std::vector<std::vector<Field>> &);
+  Status (RocksdbDB::*method_bulk_insert_)(const std::string &, const std::vector<std::string> &,
+                                           std::vector<std::vector<Field>> &);
 
   int fieldcount_;
 
@@ -96,6 +135,7 @@ class RocksdbDB : public DB {
   static rocksdb::DB *db_;
   static int ref_cnt_;
   static std::mutex mu_;
+  static std::atomic<uint64_t> sst_seq_;
 };
 
 DB *NewRocksdbDB();
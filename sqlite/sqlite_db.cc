@@ -7,9 +7,12 @@
 
 #include "query_builder.h"
 #include "core/db_factory.h"
+#include "utils/file_clone.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
+#include <filesystem>
+
 #include "sqlite_db.h"
 
 namespace {
@@ -53,6 +56,7 @@ int SqliteDB::ref_cnt_ = 0;
 std::mutex SqliteDB::mu_;
 
 std::string SqliteDB::key_;
+bool SqliteDB::binary_keys_;
 std::string SqliteDB::field_prefix_;
 size_t SqliteDB::field_count_;
 std::string SqliteDB::table_name_;
@@ -70,6 +74,15 @@ void SqliteDB::Init() {
   PrepareQueries();
 }
 
+// Binary keys are bound as blobs, which compare bytewise, rather than as
+// text that need not be valid UTF-8.
+int SqliteDB::BindKey(sqlite3_stmt *stmt, int index, const std::string &key) {
+  if (binary_keys_) {
+    return sqlite3_bind_blob(stmt, index, key.data(), key.size(), SQLITE_STATIC);
+  }
+  return sqlite3_bind_text(stmt, index, key.c_str(), key.size(), SQLITE_STATIC);
+}
+
 void SqliteDB::OpenDB() {
   const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
   if (db_path == "") {
@@ -82,6 +95,8 @@ void SqliteDB::OpenDB() {
   }
 
   key_ = props_->GetProperty(PROP_PRIMARY_KEY, PROP_PRIMARY_KEY_DEFAULT);
+  binary_keys_ = props_->GetProperty(CoreWorkload::KEY_FORMAT_PROPERTY,
+                                     CoreWorkload::KEY_FORMAT_DEFAULT) == "binary";
   field_prefix_ = props_->GetProperty(CoreWorkload::FIELD_NAME_PREFIX, CoreWorkload::FIELD_NAME_PREFIX_DEFAULT);
   field_count_ = std::stoi(props_->GetProperty(CoreWorkload::FIELD_COUNT_PROPERTY, CoreWorkload::FIELD_COUNT_DEFAULT));
   table_name_ = props_->GetProperty(CoreWorkload::TABLENAME_DEFAULT, CoreWorkload::TABLENAME_DEFAULT);
@@ -208,7 +223,7 @@ DB::Status SqliteDB::Read(const std::string &table, const std::string &key,
     stmt = SQLite3Prepare(db_, BuildReadQuery(table_name_, key_, *fields));
   }
 
-  int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
+  int rc = BindKey(stmt, 1, key);
   if (rc != SQLITE_OK) {
     s = kError;
     goto cleanup;
@@ -256,7 +271,7 @@ DB::Status SqliteDB::Scan(const std::string &table, const std::string &key, int
     stmt = SQLite3Prepare(db_, BuildScanQuery(table_name_, key_, *fields));
   }
 
-  int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
+  int rc = BindKey(stmt, 1, key);
   if (rc != SQLITE_OK) {
     s = kError;
     goto cleanup;
@@ -329,7 +344,7 @@ DB::Status SqliteDB::Update(const std::string &table, const std::string &key, st
     }
   }
 
-  rc = sqlite3_bind_text(stmt, 1+field_cnt, key.c_str(), key.size(), SQLITE_STATIC);
+  rc = BindKey(stmt, 1+field_cnt, key);
   if (rc != SQLITE_OK) {
     s = kError;
     goto cleanup;
@@ -360,7 +375,7 @@ DB::Status SqliteDB::Insert(const std::string &table, const std::string &key, st
     return kError;
   }
 
-  int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
+  int rc = BindKey(stmt, 1, key);
   if (rc != SQLITE_OK) {
     s = kError;
     goto cleanup;
@@ -390,7 +405,7 @@ DB::Status SqliteDB::Delete(const std::string &table, const std::string &key) {
   DB::Status s = kOK;
   sqlite3_stmt *stmt = stmt_delete_;
 
-  int rc = sqlite3_bind_text(stmt, 1, key.c_str(), key.size(), SQLITE_STATIC);
+  int rc = BindKey(stmt, 1, key);
   if (rc != SQLITE_OK) {
     s = kError;
     goto cleanup;
@@ -409,6 +424,67 @@ cleanup:
   return s;
 }
 
+DB::Status SqliteDB::BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                                std::vector<std::vector<Field>> &values) {
+  // the connection is shared, so only one thread at a time may hold a transaction
+  const std::lock_guard<std::mutex> lock(mu_);
+
+  int rc = sqlite3_exec(db_, "BEGIN", nullptr, nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("BulkInsert begin: ") + sqlite3_errmsg(db_));
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    DB::Status s = Insert(table, keys[i], values[i]);
+    if (s != kOK) {
+      sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+      return s;
+    }
+  }
+  rc = sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("BulkInsert commit: ") + sqlite3_errmsg(db_));
+  }
+  return kOK;
+}
+
+DB::Status SqliteDB::Snapshot(const std::string &dir) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  std::filesystem::create_directories(dir);
+  const std::string copy_path = dir + "/" + std::filesystem::path(db_path).filename().string();
+
+  sqlite3 *copy;
+  int rc = sqlite3_open_v2(copy_path.c_str(), &copy, SQLITE_OPEN_READWRITE|SQLITE_OPEN_CREATE, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("Snapshot open: ") + sqlite3_errmsg(copy));
+  }
+  sqlite3_backup *backup = sqlite3_backup_init(copy, "main", db_, "main");
+  if (backup == nullptr) {
+    throw utils::Exception(std::string("Snapshot backup: ") + sqlite3_errmsg(copy));
+  }
+  sqlite3_backup_step(backup, -1);
+  rc = sqlite3_backup_finish(backup);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("Snapshot backup: ") + sqlite3_errmsg(copy));
+  }
+  sqlite3_close(copy);
+  return kOK;
+}
+
+DB::Status SqliteDB::Restore(const std::string &dir) {
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("SQLite db path is missing");
+  }
+  const std::string copy_path = dir + "/" + std::filesystem::path(db_path).filename().string();
+  std::filesystem::remove(db_path + "-wal");
+  std::filesystem::remove(db_path + "-shm");
+  utils::CloneFile(copy_path, db_path);
+  // the restored database already has the table
+  props_->SetProperty(PROP_CREATE_TABLE, "false");
+  return kOK;
+}
+
 DB *NewSqliteDB() {
   return new SqliteDB;
 }
@@ -38,16 +38,25 @@ class SqliteDB : public DB {
 
   Status Delete(const std::string &table, const std::string &key);
 
+  Status BulkInsert(const std::string &table, const std::vector<std::string> &keys,
+                    std::vector<std::vector<Field>> &values);
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
  private:
   void OpenDB();
   void SetPragma();
   void PrepareQueries();
+  static int BindKey(sqlite3_stmt *stmt, int index, const std::string &key);
 
   static sqlite3 *db_;
   static int ref_cnt_;
   static std::mutex mu_;
 
   static std::string key_;
+  static bool binary_keys_;
   static std::string field_prefix_;
   static size_t field_count_;
   static std::string table_name_;
@@ -0,0 +1,83 @@
+//
+//  arrival.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_ARRIVAL_H_
+#define YCSB_C_ARRIVAL_H_
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+// Schedules intended start times of operations independently of their completion
+class ArrivalProcess {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum Type {
+    kFixed,
+    kPoisson
+  };
+
+  ArrivalProcess(Type type, double rate) : type_(type), rate_(rate), started_(false) {
+    if (rate <= 0) {
+      throw Exception("arrival rate must be positive");
+    }
+  }
+
+  static Type ParseType(const std::string &name) {
+    if (name == "fixed") {
+      return kFixed;
+    } else if (name == "poisson") {
+      return kPoisson;
+    }
+    throw Exception("Unknown arrival process: " + name);
+  }
+
+  ///
+  /// Waits for the intended start time of the next operation and returns it.
+  /// The returned time point lies in the past when the client is behind schedule,
+  /// so that the backlog shows up as queueing delay in the measured latency.
+  ///
+  Clock::time_point Next() {
+    if (!started_) {
+      next_ = Clock::now();
+      started_ = true;
+    } else {
+      next_ += std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(Interval()));
+    }
+    if (next_ > Clock::now()) {
+      std::this_thread::sleep_until(next_);
+    }
+    return next_;
+  }
+
+ private:
+  double Interval() {
+    if (type_ == kFixed) {
+      return 1.0 / rate_;
+    }
+    // exponential inter-arrival time, drawn from the calling client thread
+    return -std::log1p(-ThreadRandom().NextDouble()) / rate_;
+  }
+
+  Type type_;
+  double rate_;
+  bool started_;
+  Clock::time_point next_;
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_ARRIVAL_H_
@@ -0,0 +1,114 @@
+//
+//  file_clone.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_FILE_CLONE_H_
+#define YCSB_C_FILE_CLONE_H_
+
+#include <filesystem>
+#include <functional>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Copies the file src to dst. The data is shared through a reflink when the
+/// file system supports it (Linux only), and copied otherwise.
+///
+inline void CloneFile(const std::string &src, const std::string &dst) {
+#if defined(__linux__) && defined(FICLONE)
+  int in = open(src.c_str(), O_RDONLY);
+  if (in >= 0) {
+    int out = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int ret = -1;
+    if (out >= 0) {
+      ret = ioctl(out, FICLONE, in);
+      close(out);
+    }
+    close(in);
+    if (ret == 0) {
+      return;
+    }
+  }
+#endif
+  std::error_code ec;
+  std::filesystem::copy_file(src, dst, std::filesystem::copy_options::overwrite_existing, ec);
+  if (ec) {
+    throw Exception("copy " + src + " to " + dst + ": " + ec.message());
+  }
+}
+
+///
+/// Clones the directory tree src into dst. Files whose name satisfies immutable
+/// are never modified in place by the engine, so they are hard linked.
+/// Other files are cloned with CloneFile.
+///
+inline void CloneDirectory(const std::string &src, const std::string &dst,
+                           std::function<bool(const std::string &)> immutable = nullptr) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::create_directories(dst, ec);
+  if (ec) {
+    throw Exception("create " + dst + ": " + ec.message());
+  }
+  for (const fs::directory_entry &entry : fs::recursive_directory_iterator(src)) {
+    fs::path target = fs::path(dst) / fs::relative(entry.path(), src);
+    if (entry.is_directory()) {
+      fs::create_directories(target, ec);
+      if (ec) {
+        throw Exception("create " + target.string() + ": " + ec.message());
+      }
+      continue;
+    }
+    if (immutable && immutable(entry.path().filename().string())) {
+      fs::create_hard_link(entry.path(), target, ec);
+      if (!ec) {
+        continue;
+      }
+    }
+    CloneFile(entry.path().string(), target.string());
+  }
+}
+
+///
+/// Replaces the directory dst with a clone of src.
+///
+inline void RestoreDirectory(const std::string &src, const std::string &dst,
+                             std::function<bool(const std::string &)> immutable = nullptr) {
+  std::error_code ec;
+  std::filesystem::remove_all(dst, ec);
+  if (ec) {
+    throw Exception("remove " + dst + ": " + ec.message());
+  }
+  CloneDirectory(src, dst, immutable);
+}
+
+///
+/// Returns true for the table files of LevelDB-style engines, which are
+/// written once and never modified.
+///
+inline bool IsTableFile(const std::string &name) {
+  auto ends_with = [&name](const std::string &suffix) {
+    return name.size() >= suffix.size()
+           && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+  };
+  return ends_with(".sst") || ends_with(".ldb");
+}
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_FILE_CLONE_H_
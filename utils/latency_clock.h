@@ -0,0 +1,204 @@
+//
+//  latency_clock.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_LATENCY_CLOCK_H_
+#define YCSB_C_LATENCY_CLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define YCSB_C_HAVE_TSC 1
+#endif
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Clock for per-operation latencies. Reads the invariant TSC where the CPU
+/// has one, calibrated against steady_clock, and steady_clock otherwise.
+/// Init() selects the source once, before any measurement.
+///
+class LatencyClock {
+ public:
+  using SteadyClock = std::chrono::steady_clock;
+
+  ///
+  /// Selects the clock: "tsc", "steady", or "auto" for the TSC if it is
+  /// invariant. Falls back to steady_clock if the TSC is unusable.
+  /// If subtract_overhead is set, LatencyTimer deducts the overhead of the
+  /// clock reads from every latency.
+  ///
+  static void Init(const std::string &type, bool subtract_overhead) {
+    if (type != "auto" && type != "tsc" && type != "steady") {
+      throw Exception("unknown latency clock: " + type);
+    }
+    use_tsc_ = false;
+    ns_per_tick_ = 1.0;
+    if (type != "steady" && TscUsable()) {
+      Calibrate();
+      use_tsc_ = true;
+    }
+    correction_ = 0;
+    MeasureOverhead();
+    if (subtract_overhead) {
+      correction_ = overhead_;
+    }
+  }
+
+  ///
+  /// Returns the current time in ticks of the selected clock.
+  ///
+  static uint64_t Now() {
+#ifdef YCSB_C_HAVE_TSC
+    if (use_tsc_) {
+      unsigned int aux;
+      return __rdtscp(&aux);
+    }
+#endif
+    return SteadyTicks(SteadyClock::now());
+  }
+
+  ///
+  /// Converts a number of ticks to nanoseconds.
+  ///
+  static uint64_t ToNanos(uint64_t ticks) {
+    return use_tsc_ ? static_cast<uint64_t>(ticks * ns_per_tick_) : ticks;
+  }
+
+  ///
+  /// Converts a steady_clock time point in the recent past to ticks.
+  ///
+  static uint64_t FromSteady(SteadyClock::time_point t) {
+    if (!use_tsc_) {
+      return SteadyTicks(t);
+    }
+    uint64_t now = Now();
+    int64_t ago = std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - t).count();
+    return now - static_cast<uint64_t>(ago / ns_per_tick_);
+  }
+
+  static std::string Name() {
+    return use_tsc_ ? "tsc" : "steady";
+  }
+  ///
+  /// Returns the ticks per nanosecond, 1 for steady_clock.
+  ///
+  static double TicksPerNano() {
+    return 1.0 / ns_per_tick_;
+  }
+  ///
+  /// Returns the latency measured for an empty operation, in nanoseconds.
+  ///
+  static uint64_t Overhead() {
+    return overhead_;
+  }
+  ///
+  /// Returns the nanoseconds LatencyTimer deducts from every latency.
+  ///
+  static uint64_t Correction() {
+    return correction_;
+  }
+
+ private:
+  static uint64_t SteadyTicks(SteadyClock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+  }
+
+  static bool TscUsable() {
+#ifdef YCSB_C_HAVE_TSC
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+      return false;
+    }
+    // rdtscp
+    __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+    if ((edx & (1u << 27)) == 0) {
+      return false;
+    }
+    // invariant TSC: constant rate, synchronized across cores
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+  }
+
+  static void Calibrate() {
+#ifdef YCSB_C_HAVE_TSC
+    unsigned int aux;
+    SteadyClock::time_point t0 = SteadyClock::now();
+    uint64_t c0 = __rdtscp(&aux);
+    SteadyClock::time_point t1;
+    do {
+      t1 = SteadyClock::now();
+    } while (t1 - t0 < std::chrono::milliseconds(50));
+    uint64_t c1 = __rdtscp(&aux);
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    ns_per_tick_ = ns / (c1 - c0);
+#endif
+  }
+
+  static void MeasureOverhead() {
+    const int kRounds = 100000;
+    uint64_t total = 0;
+    for (int i = 0; i < kRounds; i++) {
+      uint64_t start = Now();
+      total += ToNanos(Now() - start);
+    }
+    overhead_ = total / kRounds;
+  }
+
+  static inline bool use_tsc_ = false;
+  static inline double ns_per_tick_ = 1.0;
+  static inline uint64_t overhead_ = 0;
+  static inline uint64_t correction_ = 0;
+};
+
+///
+/// Measures the latency of one operation with the LatencyClock.
+///
+class LatencyTimer {
+ public:
+  void Start() {
+    start_ = LatencyClock::Now();
+  }
+
+  ///
+  /// Starts the timer at the given point, e.g. the intended start time of an
+  /// operation scheduled by an open-loop client.
+  ///
+  void Start(LatencyClock::SteadyClock::time_point t) {
+    start_ = LatencyClock::FromSteady(t);
+  }
+
+  ///
+  /// Returns the nanoseconds since Start().
+  ///
+  uint64_t End() {
+    int64_t ticks = static_cast<int64_t>(LatencyClock::Now() - start_);
+    if (ticks <= 0) {
+      return 0;
+    }
+    uint64_t ns = LatencyClock::ToNanos(ticks);
+    uint64_t correction = LatencyClock::Correction();
+    return ns > correction ? ns - correction : 0;
+  }
+
+ private:
+  uint64_t start_;
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_LATENCY_CLOCK_H_
@@ -28,6 +28,7 @@ class Properties {
   void SetProperty(const std::string &key, const std::string &value);
   bool ContainsKey(const std::string &key) const;
   void Load(std::ifstream &input);
+  const std::map<std::string, std::string> &properties() const { return properties_; }
  private:
   std::map<std::string, std::string> properties_;
 };
@@ -0,0 +1,147 @@
+//
+//  random.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_RANDOM_H_
+#define YCSB_C_RANDOM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// xoshiro256** pseudo random number generator.
+///
+class Random {
+ public:
+  explicit Random(uint64_t seed = 0) { Seed(seed); }
+
+  ///
+  /// Seeds the state through splitmix64, as recommended by the authors.
+  ///
+  void Seed(uint64_t seed) {
+    for (uint64_t &s : s_) {
+      s = SplitMix64(seed);
+    }
+  }
+
+  uint64_t Next() {
+    const uint64_t result = Rotl(s_[1] * 5, 7) * 9;
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = Rotl(s_[3], 45);
+    return result;
+  }
+
+  ///
+  /// Returns a double in [0, 1).
+  ///
+  double NextDouble() {
+    return (Next() >> 11) * 0x1.0p-53;
+  }
+
+  ///
+  /// Returns an integer in [0, n), or any integer if n is zero.
+  ///
+  uint64_t Uniform(uint64_t n) {
+    if (n == 0) {
+      return Next();
+    }
+    return MulHigh(Next(), n);
+  }
+
+  static uint64_t SplitMix64(uint64_t &x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+ private:
+  ///
+  /// Returns the high 64 bits of the 128-bit product of a and b.
+  ///
+  static uint64_t MulHigh(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    return __umulh(a, b);
+#else
+    const uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+    const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi;
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+  }
+
+  static uint64_t Rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  uint64_t s_[4];
+};
+
+///
+/// Per-thread generators derived from one process-wide seed. A thread seeded
+/// with SeedThread(stream) draws the same sequence in every run with the
+/// same seed; other threads get a stream of their own on first use.
+///
+class ThreadRandomState {
+ public:
+  static void SetSeed(uint64_t seed) {
+    seed_ = seed;
+  }
+  static uint64_t GetSeed() {
+    return seed_;
+  }
+  static void SeedThread(uint64_t stream) {
+    uint64_t x = stream;
+    state_.rng.Seed(seed_ ^ Random::SplitMix64(x));
+    state_.seeded = true;
+  }
+  static Random &Get() {
+    if (!state_.seeded) {
+      SeedThread(next_stream_.fetch_add(1, std::memory_order_relaxed));
+    }
+    return state_.rng;
+  }
+
+ private:
+  struct State {
+    State() : seeded(false) {}
+    Random rng;
+    bool seeded;
+  };
+
+  static inline uint64_t seed_ = std::random_device{}();
+  // streams of threads that are not seeded explicitly
+  static inline std::atomic<uint64_t> next_stream_{1ull << 32};
+  static inline thread_local State state_;
+};
+
+///
+/// Returns the generator of the calling thread.
+///
+inline Random &ThreadRandom() {
+  return ThreadRandomState::Get();
+}
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_RANDOM_H_
@@ -0,0 +1,114 @@
+//
+//  shard_registry.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_SHARD_REGISTRY_H_
+#define YCSB_C_SHARD_REGISTRY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Keeps one Shard per thread, so that threads update their own state without
+/// sharing cache lines. Readers visit the shards of all threads without locking.
+///
+/// Shard must be default constructible and provide Clear(), which is only
+/// called by the owning thread. Reset() makes every shard empty: readers skip
+/// the shards that were not cleared since, and each owner clears its shard on
+/// its next call to Local().
+///
+template <typename Shard>
+class ShardRegistry {
+ public:
+  ShardRegistry() : id_(next_id_.fetch_add(1) + 1), head_(nullptr), epoch_(0) {}
+  ~ShardRegistry() {
+    Node *node = head_.load(std::memory_order_acquire);
+    while (node != nullptr) {
+      Node *next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+  ShardRegistry(const ShardRegistry &) = delete;
+  ShardRegistry &operator=(const ShardRegistry &) = delete;
+
+  ///
+  /// Returns the shard of the calling thread, registering it on first use.
+  ///
+  Shard *Local() {
+    Node *node = (cache_.registry == id_) ? cache_.node : Register();
+    uint64_t epoch = epoch_.load(std::memory_order_acquire);
+    if (node->epoch.load(std::memory_order_relaxed) != epoch) {
+      node->shard.Clear();
+      node->epoch.store(epoch, std::memory_order_release);
+    }
+    return &node->shard;
+  }
+
+  ///
+  /// Calls f on every shard that has been updated since the last Reset().
+  /// The owners may keep updating their shards while f runs.
+  ///
+  template <typename F>
+  void ForEach(F f) const {
+    uint64_t epoch = epoch_.load(std::memory_order_acquire);
+    for (Node *node = head_.load(std::memory_order_acquire); node != nullptr; node = node->next) {
+      if (node->epoch.load(std::memory_order_acquire) == epoch) {
+        f(static_cast<const Shard &>(node->shard));
+      }
+    }
+  }
+
+  void Reset() {
+    epoch_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+ private:
+  struct Node {
+    Shard shard;
+    std::thread::id owner;
+    std::atomic<uint64_t> epoch;
+    Node *next;
+  };
+  struct Cache {
+    uint64_t registry;
+    Node *node;
+  };
+
+  Node *Register() {
+    std::thread::id self = std::this_thread::get_id();
+    Node *node = head_.load(std::memory_order_acquire);
+    while (node != nullptr && node->owner != self) {
+      node = node->next;
+    }
+    if (node == nullptr) {
+      node = new Node();
+      node->owner = self;
+      node->epoch.store(epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      node->next = head_.load(std::memory_order_relaxed);
+      while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                          std::memory_order_relaxed));
+    }
+    cache_ = {id_, node};
+    return node;
+  }
+
+  static inline std::atomic<uint64_t> next_id_{0};
+  static inline thread_local Cache cache_{0, nullptr};
+
+  const uint64_t id_;
+  std::atomic<Node *> head_;
+  std::atomic<uint64_t> epoch_;
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_SHARD_REGISTRY_H_
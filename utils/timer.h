@@ -18,10 +18,20 @@ namespace utils {
 template <typename R, typename P = std::ratio<1>>
 class Timer {
  public:
+  using Clock = std::chrono::steady_clock;
+
   void Start() {
     time_ = Clock::now();
   }
 
+  ///
+  /// Starts the timer at the given point, e.g. the intended start time of an
+  /// operation scheduled by an open-loop client.
+  ///
+  void Start(Clock::time_point t) {
+    time_ = t;
+  }
+
   R End() {
     Duration span;
     Clock::time_point t = Clock::now();
@@ -31,7 +41,6 @@ class Timer {
 
  private:
   using Duration = std::chrono::duration<R, P>;
-  using Clock = std::chrono::high_resolution_clock;
 
   Clock::time_point time_;
 };
@@ -15,6 +15,9 @@
 #include <exception>
 #include <random>
 #include <locale>
+#include <string>
+
+#include "random.h"
 
 #if defined(_MSC_VER)
 #if _MSC_VER >= 1911
@@ -49,23 +52,18 @@ inline uint64_t FNVHash64(uint64_t val) {
 inline uint64_t Hash(uint64_t val) { return FNVHash64(val); }
 
 inline uint32_t ThreadLocalRandomInt() {
-  static thread_local std::random_device rd;
-  static thread_local std::minstd_rand rn(rd());
-  return rn();
+  return ThreadRandom().Next() >> 32;
 }
 
 inline double ThreadLocalRandomDouble(double min = 0.0, double max = 1.0) {
-  static thread_local std::random_device rd;
-  static thread_local std::minstd_rand rn(rd());
-  static thread_local std::uniform_real_distribution<double> uniform(min, max);
-  return uniform(rn);
+  return min + (max - min) * ThreadRandom().NextDouble();
 }
 
 ///
 /// Returns an ASCII code that can be printed to desplay
 ///
 inline char RandomPrintChar() {
-  return rand() % 94 + 33;
+  return ThreadRandom().Uniform(94) + 33;
 }
 
 class Exception : public std::exception {
@@ -95,6 +93,32 @@ inline std::string Trim(const std::string &str) {
       [](int c){ return std::isspace(c); }).base());
 }
 
+///
+/// Returns str as a quoted JSON string.
+///
+inline std::string JsonQuote(const std::string &str) {
+  static const char hex[] = "0123456789abcdef";
+  std::string quoted = "\"";
+  for (unsigned char c : str) {
+    switch (c) {
+      case '"': quoted += "\\\""; break;
+      case '\\': quoted += "\\\\"; break;
+      case '\n': quoted += "\\n"; break;
+      case '\r': quoted += "\\r"; break;
+      case '\t': quoted += "\\t"; break;
+      default:
+        if (c < 0x20) {
+          quoted += "\\u00";
+          quoted += hex[c >> 4];
+          quoted += hex[c & 0xf];
+        } else {
+          quoted += c;
+        }
+    }
+  }
+  return quoted + "\"";
+}
+
 } // utils
 
 } // ycsbc
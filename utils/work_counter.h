@@ -0,0 +1,55 @@
+//
+//  work_counter.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_WORK_COUNTER_H_
+#define YCSB_C_WORK_COUNTER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Hands out a fixed amount of work to client threads in small chunks, so
+/// that faster threads take over the work a slow thread would otherwise hold.
+///
+class WorkCounter {
+ public:
+  WorkCounter(int64_t total, int64_t chunk) : total_(total), chunk_(std::max<int64_t>(chunk, 1)), next_(0) {}
+
+  ///
+  /// Claims the next chunk of work.
+  ///
+  /// @param start Set to the index of the first claimed unit.
+  /// @return The number of claimed units, or zero when all work is handed out.
+  ///
+  int64_t Claim(int64_t *start) {
+    int64_t first = next_.fetch_add(chunk_, std::memory_order_relaxed);
+    if (first >= total_) {
+      return 0;
+    }
+    *start = first;
+    return std::min(chunk_, total_ - first);
+  }
+
+  int64_t Claim() {
+    int64_t start;
+    return Claim(&start);
+  }
+
+ private:
+  const int64_t total_;
+  const int64_t chunk_;
+  std::atomic<int64_t> next_;
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_WORK_COUNTER_H_
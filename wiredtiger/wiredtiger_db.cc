@@ -15,6 +15,8 @@
 
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/row_codec.h"
+#include "utils/file_clone.h"
 #include "utils/utils.h"
 
 #include "wiredtiger_db.h"
@@ -218,10 +220,12 @@ DB::Status WTDB::ReadSingleEntry(const std::string &table, const std::string &ke
     throw utils::Exception(WT_PREFIX " search error");
   }
   error_check(cursor_->get_value(cursor_, &v));
+  RowReader row((const char*)v.data, v.size);
   if (fields != nullptr) {
-    DeserializeRowFilter(&result, (const char*)v.data, v.size, *fields);
+    row.Decode(*fields, result);
   } else {
-    DeserializeRow(&result, (const char*)v.data, v.size);
+    row.Decode(result);
+    assert(result.size() == static_cast<size_t>(fieldcount_));
   }
   return kOK;
 }
@@ -234,25 +238,37 @@ DB::Status WTDB::ScanSingleEntry(const std::string &table, const std::string &ke
   int ret = 0, exact;
 
   cursor_->set_key(cursor_, &k);
-  error_check(cursor_->search_near(cursor_, &exact));
+  ret = cursor_->search_near(cursor_, &exact);
+  if (ret == WT_NOTFOUND) {
+    return kNotFound;
+  } else if (ret != 0) {
+    throw utils::Exception(WT_PREFIX " search_near error");
+  }
+  // search_near may land on the key before a deleted one
   if (exact < 0) {
     ret = cursor_->next(cursor_);
   }
   for(int i=0; !ret && i<len; ++i){
     error_check(cursor_->get_value(cursor_, &v));
     result.emplace_back(std::vector<Field>());
+    RowReader row((const char*)v.data, v.size);
     if (fields != nullptr) {
-      DeserializeRowFilter(&result.back(), (const char*)v.data, v.size, *fields);
+      row.Decode(*fields, result.back());
     } else {
-      DeserializeRow(&result.back(), (const char*)v.data, v.size);
+      row.Decode(result.back());
+      assert(result.back().size() == static_cast<size_t>(fieldcount_));
     }
+    ret = cursor_->next(cursor_);
+  }
+  if (ret != 0 && ret != WT_NOTFOUND) {
+    throw utils::Exception(WT_PREFIX " next error");
   }
+  error_check(cursor_->reset(cursor_));
   return kOK;
 }
 
 DB::Status WTDB::UpdateSingleEntry(const std::string &table, const std::string &key,
                            std::vector<Field> &values){
-  std::vector<Field> current_values;
   WT_ITEM k = {key.data(), key.size()};
   WT_ITEM v;
   int ret;
@@ -265,21 +281,8 @@ DB::Status WTDB::UpdateSingleEntry(const std::string &table, const std::string &
     throw utils::Exception(WT_PREFIX " search error");
   }
   error_check(cursor_->get_value(cursor_, &v));
-  DeserializeRow(&current_values, (const char*)v.data, v.size);
-  for (Field &new_field : values) {
-    bool found MAYBE_UNUSED = false;
-    for (Field &cur_field : current_values) {
-      if (cur_field.name == new_field.name) {
-        found = true;
-        cur_field.value = new_field.value;
-        break;
-      }
-    }
-    assert(found);
-  }
-
   std::string data;
-  SerializeRow(current_values, &data);
+  UpdateRow(RowReader((const char*)v.data, v.size), values, data);
   v.data = data.data();
   v.size = data.size();
   cursor_->set_value(cursor_, &v);
@@ -298,7 +301,7 @@ DB::Status WTDB::InsertSingleEntry(const std::string &table, const std::string &
   WT_ITEM k = {key.data(), key.size()}, v;
   
   cursor_->set_key(cursor_, &k);
-  SerializeRow(values, &data);
+  EncodeRow(values, data);
   v.data = data.data();
   v.size = data.size();
   cursor_->set_value(cursor_, &v);
@@ -313,56 +316,35 @@ DB::Status WTDB::DeleteSingleEntry(const std::string &table, const std::string &
   return kOK;
 }
 
-void WTDB::SerializeRow(const std::vector<Field> &values, std::string *data) {
-  for (const Field &field : values) {
-    uint32_t len = field.name.size();
-    data->append(reinterpret_cast<char *>(&len), sizeof(uint32_t)); // 4B
-    data->append(field.name.data(), field.name.size());             // len(name)
-    len = field.value.size();
-    data->append(reinterpret_cast<char *>(&len), sizeof(uint32_t)); // 4B
-    data->append(field.value.data(), field.value.size());           // len(value)
+DB::Status WTDB::Snapshot(const std::string &dir) {
+  const std::string &home = props_->GetProperty(PROP_HOME, PROP_HOME_DEFAULT);
+  int ret = mkdir(dir.c_str(), 0775);
+  if (ret) {
+    throw utils::Exception(std::string("Snapshot mkdir: ") + strerror(errno));
   }
-}
-
-void WTDB::DeserializeRow(std::vector<Field> *values, const char *data_ptr, size_t data_len) {
-  const char *p = data_ptr;
-  const char *lim = p + data_len;
-  while (p != lim) {
-    assert(p < lim);
-    uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string field(p, static_cast<const size_t>(len));
-    p += len;
-    len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string value(p, static_cast<const size_t>(len));
-    p += len;
-    values->push_back({field, value});
+  // a checkpoint makes the loaded data durable, the backup cursor lists the files to copy
+  error_check(session_->checkpoint(session_, NULL));
+  WT_CURSOR *backup_cursor;
+  error_check(session_->open_cursor(session_, "backup:", NULL, NULL, &backup_cursor));
+  while ((ret = backup_cursor->next(backup_cursor)) == 0) {
+    const char *filename;
+    error_check(backup_cursor->get_key(backup_cursor, &filename));
+    utils::CloneFile(home + "/" + filename, dir + "/" + filename);
+  }
+  if (ret != WT_NOTFOUND) {
+    error_check(ret);
   }
-  assert(values->size() == fieldcount_);
+  error_check(backup_cursor->close(backup_cursor));
+  return kOK;
 }
 
-void WTDB::DeserializeRowFilter(std::vector<Field> *values, const char *data_ptr, size_t data_len,
-                                  const std::vector<std::string> &fields) {
-  const char *p = data_ptr;
-  const char *lim = p + data_len;
-  std::vector<std::string>::const_iterator filter_iter = fields.begin();
-  while (p != lim && filter_iter != fields.end()) {
-    assert(p < lim);
-    uint32_t len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string field(p, static_cast<const size_t>(len));
-    p += len;
-    len = *reinterpret_cast<const uint32_t *>(p);
-    p += sizeof(uint32_t);
-    std::string value(p, static_cast<const size_t>(len));
-    p += len;
-    if (*filter_iter == field) {
-      values->push_back({field, value});
-      filter_iter++;
-    }
+DB::Status WTDB::Restore(const std::string &dir) {
+  const std::string &home = props_->GetProperty(PROP_HOME, PROP_HOME_DEFAULT);
+  if (home.empty()) {
+    throw utils::Exception(WT_PREFIX " home is missing");
   }
-  assert(values->size() == fields.size());
+  utils::RestoreDirectory(dir, home);
+  return kOK;
 }
 
 DB *NewWTDB() {
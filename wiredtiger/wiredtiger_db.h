@@ -46,6 +46,10 @@ class WTDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
  private:
 
   Status ReadSingleEntry(const std::string &table, const std::string &key,
@@ -59,10 +63,6 @@ class WTDB : public DB {
                            std::vector<Field> &values);
   Status DeleteSingleEntry(const std::string &table, const std::string &key);
 
-  void SerializeRow(const std::vector<Field> &values, std::string *data);
-  void DeserializeRow(std::vector<Field> *values, const char *data_ptr, size_t data_len);
-  void DeserializeRowFilter(std::vector<Field> *values, const char *data_ptr, size_t data_len, const std::vector<std::string> &fields);
-
   Status (WTDB::*method_read_)(const std::string &, const std:: string &,
                                     const std::vector<std::string> *, std::vector<Field> &);
   Status (WTDB::*method_scan_)(const std::string &, const std::string &, int,